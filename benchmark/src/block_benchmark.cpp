@@ -0,0 +1,328 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+
+#include "storage/block_manager.h"
+
+using namespace mtfs::storage;
+
+// =============================================================================
+// CONCURRENT BLOCK I/O: ONE I/O IN FLIGHT VS POSITIONAL READS AND WRITES
+// =============================================================================
+
+// Runs opsPerThread random block operations per thread, a quarter of them
+// writes. Each thread writes only its own slice of the blocks. With
+// serialize set every call holds one global lock, like the old
+// CRITICAL_SECTION around a shared seek-then-read stream.
+double measure_block_io(BlockManager& blocks, const std::vector<int>& ids, size_t threadCount,
+                        size_t opsPerThread, bool serialize) {
+    std::atomic<bool> start{false};
+    std::atomic<size_t> failures{0};
+    std::mutex globalLock;
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 rng(static_cast<unsigned>(t) + 1);
+            size_t sliceSize = ids.size() / threadCount;
+            std::vector<char> out(BlockManager::BLOCK_SIZE, static_cast<char>('a' + t % 26));
+            std::vector<char> in;
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < opsPerThread; ++i) {
+                bool write = rng() % 4 == 0;
+                int id = write ? ids[t * sliceSize + rng() % sliceSize] : ids[rng() % ids.size()];
+                std::unique_lock<std::mutex> lock(globalLock, std::defer_lock);
+                if (serialize) {
+                    lock.lock();
+                }
+                bool ok = write ? blocks.writeBlock(id, out) : blocks.readBlock(id, in);
+                if (!ok) {
+                    failures++;
+                }
+            }
+        });
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    start.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    if (failures > 0) {
+        std::cerr << failures << " block operations failed" << std::endl;
+    }
+    double seconds = std::chrono::duration<double>(end_time - start_time).count();
+    return (threadCount * opsPerThread) / seconds;
+}
+
+void benchmark_concurrent_block_io() {
+    std::cout << "\n=== Concurrent Block I/O: Serialized vs Positional (pread/pwrite) ===" << std::endl;
+
+    const std::string path = "./block_benchmark_storage.bin";
+    const size_t opsPerThread = 50000;
+    const size_t maxThreads = std::max<size_t>(8, std::thread::hardware_concurrency());
+
+    std::vector<int> ids;
+    {
+        BlockManager blocks(path);
+        blocks.formatStorage();
+        std::vector<char> fill(BlockManager::BLOCK_SIZE, 'x');
+        for (size_t i = 0; i < BlockManager::INITIAL_BLOCKS; ++i) {
+            int id = blocks.allocateBlock();
+            blocks.writeBlock(id, fill);
+            ids.push_back(id);
+        }
+
+        std::cout << "Blocks: " << ids.size() << " x " << BlockManager::BLOCK_SIZE
+                  << " bytes, 25% writes, ops per thread: " << opsPerThread
+                  << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+        std::cout << std::setw(8) << "Threads"
+                  << std::setw(22) << "Serialized (ops/s)"
+                  << std::setw(22) << "Positional (ops/s)"
+                  << std::setw(10) << "Speedup" << std::endl;
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            double serialized = measure_block_io(blocks, ids, threads, opsPerThread, true);
+            double positional = measure_block_io(blocks, ids, threads, opsPerThread, false);
+            std::cout << std::setw(8) << threads
+                      << std::setw(22) << std::fixed << std::setprecision(0) << serialized
+                      << std::setw(22) << positional
+                      << std::setw(9) << std::setprecision(2) << (positional / serialized) << "x" << std::endl;
+        }
+    }
+    std::remove(path.c_str());
+}
+
+// =============================================================================
+// ONLINE GROWTH: ALLOCATING FAR PAST THE INITIAL 4 MiB
+// =============================================================================
+
+void benchmark_online_growth() {
+    std::cout << "\n=== Online Growth: Allocation Across Segments ===" << std::endl;
+
+    const std::string path = "./block_benchmark_growth.bin";
+    const size_t targetBlocks = 200000;  // About 780 MiB of block space
+
+    {
+        BlockManager blocks(path);
+        blocks.formatStorage();
+        std::cout << "Initial blocks: " << blocks.getTotalBlocks()
+                  << ", segment size: " << BlockManager::SEGMENT_BLOCKS << " blocks" << std::endl;
+
+        std::vector<int> ids;
+        ids.reserve(targetBlocks);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < targetBlocks; ++i) {
+            int id = blocks.allocateBlock();
+            if (id < 0) {
+                std::cerr << "Allocation failed after " << i << " blocks" << std::endl;
+                break;
+            }
+            ids.push_back(id);
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+        size_t segments = 1 + (blocks.getTotalBlocks() - BlockManager::INITIAL_BLOCKS) / BlockManager::SEGMENT_BLOCKS;
+        std::cout << "Allocated " << ids.size() << " blocks in " << std::fixed << std::setprecision(3) << seconds
+                  << " s (" << std::setprecision(0) << ids.size() / seconds << " allocs/s)" << std::endl;
+        std::cout << "Total blocks: " << blocks.getTotalBlocks() << " in " << segments << " segments ("
+                  << (blocks.getTotalBlocks() * BlockManager::BLOCK_SIZE) / (1024 * 1024) << " MiB)" << std::endl;
+
+        // Free every other block so the next pass has to search for holes
+        for (size_t i = 0; i < ids.size(); i += 2) {
+            blocks.freeBlock(ids[i]);
+        }
+        start_time = std::chrono::high_resolution_clock::now();
+        size_t refilled = 0;
+        for (size_t i = 0; i < ids.size(); i += 2) {
+            if (blocks.allocateBlock() >= 0) {
+                refilled++;
+            }
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        seconds = std::chrono::duration<double>(end_time - start_time).count();
+        std::cout << "Refilled " << refilled << " freed blocks at " << std::setprecision(0)
+                  << refilled / seconds << " allocs/s" << std::endl;
+
+        const size_t queries = 10000;
+        start_time = std::chrono::high_resolution_clock::now();
+        size_t free = 0;
+        for (size_t i = 0; i < queries; ++i) {
+            free += blocks.getFreeBlocks();
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        double nanos = std::chrono::duration<double, std::nano>(end_time - start_time).count() / queries;
+        std::cout << "getFreeBlocks(): " << free / queries << " free, " << std::setprecision(1)
+                  << nanos << " ns per call" << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+// =============================================================================
+// FREE-SPACE SEARCH ON A NEARLY FULL STORE
+// =============================================================================
+
+void benchmark_nearly_full_allocation() {
+    std::cout << "\n=== Free-Space Search: Allocation on a 99% Full Store ===" << std::endl;
+
+    const std::string path = "./block_benchmark_full.bin";
+    const size_t segmentCount = 8;
+
+    {
+        BlockManager blocks(path);
+        blocks.formatStorage();
+        size_t capacity = BlockManager::INITIAL_BLOCKS + (segmentCount - 1) * BlockManager::SEGMENT_BLOCKS;
+        std::vector<int> ids;
+        ids.reserve(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            ids.push_back(blocks.allocateBlock());
+        }
+
+        // Free 1% at random; the holes are spread over every segment
+        std::mt19937 rng(42);
+        std::shuffle(ids.begin(), ids.end(), rng);
+        size_t holes = capacity / 100;
+        for (size_t i = 0; i < holes; ++i) {
+            blocks.freeBlock(ids[i]);
+        }
+        std::cout << "Store: " << blocks.getTotalBlocks() << " blocks, " << blocks.getFreeBlocks()
+                  << " free" << std::endl;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        size_t refilled = 0;
+        for (size_t i = 0; i < holes; ++i) {
+            if (blocks.allocateBlock() >= 0) {
+                refilled++;
+            }
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(end_time - start_time).count();
+        std::cout << "Filled " << refilled << " holes, " << std::fixed << std::setprecision(2)
+                  << micros / refilled << " us per allocation" << std::endl;
+        std::cout << "Free blocks after refill: " << blocks.getFreeBlocks() << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+// =============================================================================
+// EXTENTS: ONE LARGE I/O VS PER-BLOCK I/O ON SCATTERED BLOCKS
+// =============================================================================
+
+void benchmark_extent_io() {
+    std::cout << "\n=== Extents: Contiguous Files vs Scattered Blocks ===" << std::endl;
+
+    const std::string path = "./block_benchmark_extents.bin";
+    const size_t fileCount = 64;
+    const size_t blocksPerFile = 256;  // 1 MiB files
+    const size_t passes = 5;
+
+    {
+        BlockManager blocks(path);
+        blocks.formatStorage();
+
+        // Files written together, one block at a time, end up interleaved
+        std::vector<std::vector<int>> scattered(fileCount);
+        for (size_t b = 0; b < blocksPerFile; ++b) {
+            for (size_t f = 0; f < fileCount; ++f) {
+                scattered[f].push_back(blocks.allocateBlock());
+            }
+        }
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::vector<int> extents;
+        for (size_t f = 0; f < fileCount; ++f) {
+            extents.push_back(blocks.allocateBlocks(blocksPerFile));
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double allocMicros = std::chrono::duration<double, std::micro>(end_time - start_time).count() / fileCount;
+
+        std::vector<char> file(blocksPerFile * BlockManager::BLOCK_SIZE, 'e');
+        std::vector<char> block(BlockManager::BLOCK_SIZE, 's');
+        for (size_t f = 0; f < fileCount; ++f) {
+            blocks.writeBlocks(extents[f], file);
+            for (int id : scattered[f]) {
+                blocks.writeBlock(id, block);
+            }
+        }
+
+        std::vector<char> in;
+        start_time = std::chrono::high_resolution_clock::now();
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (size_t f = 0; f < fileCount; ++f) {
+                for (int id : scattered[f]) {
+                    blocks.readBlock(id, in);
+                }
+            }
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        double scatteredSeconds = std::chrono::duration<double>(end_time - start_time).count();
+
+        start_time = std::chrono::high_resolution_clock::now();
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (size_t f = 0; f < fileCount; ++f) {
+                blocks.readBlocks(extents[f], blocksPerFile, in);
+            }
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        double extentSeconds = std::chrono::duration<double>(end_time - start_time).count();
+
+        double mib = static_cast<double>(passes * fileCount * blocksPerFile * BlockManager::BLOCK_SIZE) / (1024 * 1024);
+        std::cout << fileCount << " files x " << blocksPerFile << " blocks, " << passes << " read passes" << std::endl;
+        std::cout << "Extent allocation: " << std::fixed << std::setprecision(2) << allocMicros << " us per file"
+                  << std::endl;
+        std::cout << "Scattered, readBlock per block: " << std::setprecision(0) << mib / scatteredSeconds
+                  << " MiB/s" << std::endl;
+        std::cout << "Extent, one readBlocks per file: " << mib / extentSeconds << " MiB/s ("
+                  << std::setprecision(2) << scatteredSeconds / extentSeconds << "x)" << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+int main(int argc, char* argv[]) {
+    std::cout << "=========================================" << std::endl;
+    std::cout << "        BLOCK STORAGE BENCHMARKS         " << std::endl;
+    std::cout << "=========================================" << std::endl;
+
+    if (argc > 1 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h")) {
+        std::cout << "Usage: " << argv[0] << std::endl;
+        std::cout << "Runs block I/O micro-benchmarks against mtfs::storage::BlockManager" << std::endl;
+        return 0;
+    }
+
+    try {
+        std::cout << "\n1. Concurrent Block I/O" << std::endl;
+        benchmark_concurrent_block_io();
+
+        std::cout << "\n2. Online Growth" << std::endl;
+        benchmark_online_growth();
+
+        std::cout << "\n3. Free-Space Search" << std::endl;
+        benchmark_nearly_full_allocation();
+
+        std::cout << "\n4. Extent I/O" << std::endl;
+        benchmark_extent_io();
+    } catch (const std::exception& e) {
+        std::cerr << "\nBenchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=========================================" << std::endl;
+    std::cout << "     ALL BLOCK BENCHMARKS COMPLETED!     " << std::endl;
+    std::cout << "=========================================" << std::endl;
+    return 0;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "cache/lz_codec.hpp"
+#include "cache/spill_tier.hpp"
+
+namespace mtfs::cache {
+
+struct CompressionStatistics {
+    size_t hits{0};            // Lookups served by decompressing an entry
+    size_t misses{0};
+    size_t stored{0};          // Evicted entries compressed into the tier
+    size_t incompressible{0};  // Evicted entries passed on uncompressed
+    size_t dropped{0};         // Entries pushed out to stay in budget
+    size_t residentEntries{0};
+    size_t residentBytes{0};   // Compressed size of the resident entries
+    size_t rawBytes{0};        // Their size before compression
+    uint64_t compressNanos{0};
+    uint64_t decompressNanos{0};
+    double hitRate{0.0};
+    double compressionRatio{0.0};
+
+    void updateHitRate() {
+        size_t total = hits + misses;
+        hitRate = total > 0 ? (static_cast<double>(hits) / total) * 100.0 : 0.0;
+        compressionRatio = residentBytes > 0 ? static_cast<double>(rawBytes) / residentBytes : 0.0;
+    }
+};
+
+// Cold part of the memory budget. Entries evicted from the shards are
+// serialized with their SpillCodec and compressed with lzCompress; a miss
+// that finds them here decompresses them and moves them back, so only the
+// hottest entries are kept as plain values. Values that do not compress
+// and entries pushed out by newer ones go to the overflow listener, e.g.
+// the spill tier. Entries are charged their plain weight scaled by the
+// compression ratio. The cache manager calls store() once the shard lock
+// is released, and compression runs outside the tier lock as well.
+template<typename Key, typename Value>
+class CompressedTier {
+public:
+    using OverflowListener = std::function<void(const Key&, const Value&)>;
+
+    explicit CompressedTier(size_t capacityBytes);
+
+    CompressedTier(const CompressedTier&) = delete;
+    CompressedTier& operator=(const CompressedTier&) = delete;
+
+    // Compress an evicted entry, replacing any older copy; weight is what
+    // the plain value was charged
+    void store(const Key& key, const Value& value, size_t weight);
+    // Remove and decompress the stored copy, counting a tier hit or miss
+    std::optional<Value> take(const Key& key);
+    // Invalidate the stored copy
+    void remove(const Key& key);
+    // Drop a copy that is about to be replaced in memory; unlike remove()
+    // this leaves concurrent promotions alone
+    void discard(const Key& key);
+    size_t removeIf(const std::function<bool(const Key&)>& predicate);
+    void clear();
+    void setCapacity(size_t capacityBytes);
+    size_t capacity() const;
+    void setOverflowListener(OverflowListener listener);
+
+    // Bumped by remove(), removeIf() and clear(); lets a promotion that
+    // raced with an invalidation notice it
+    uint64_t getInvalidations() const { return invalidations.load(); }
+
+    CompressionStatistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    struct Entry {
+        Key key;
+        std::string packed;
+        size_t rawSize;
+        size_t weight;
+    };
+    using EntryList = std::list<Entry>;
+
+    void erase(typename EntryList::iterator it);
+    void shrinkTo(size_t budget);
+    std::optional<Value> unpack(const Entry& entry) const;
+
+    EntryList entries;  // Most recently stored first
+    std::unordered_map<Key, typename EntryList::iterator> lookup;
+    size_t maxBytes;
+    size_t currentBytes{0};
+    size_t rawBytes{0};
+    OverflowListener overflow;
+    std::atomic<uint64_t> invalidations{0};
+    CompressionStatistics stats;
+    mutable std::mutex tierMutex;
+};
+
+} // namespace mtfs::cache
+
+// Include implementation files
+#include "compressed_tier.tpp"
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace mtfs::cache {
+
+// ===== CompressedTier Implementation =====
+
+template<typename Key, typename Value>
+CompressedTier<Key, Value>::CompressedTier(size_t capacityBytes) : maxBytes(capacityBytes) {}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::store(const Key& key, const Value& value, size_t weight) {
+    std::string encoded;
+    std::string packed;
+    auto start = std::chrono::steady_clock::now();
+    bool compressed = SpillCodec<Value>::encode(value, encoded) &&
+                      lzCompress(encoded.data(), encoded.size(), packed);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (compressed) {
+        weight = std::max<size_t>(1, weight * packed.size() / encoded.size());
+    }
+
+    std::lock_guard<std::mutex> lock(tierMutex);
+    stats.compressNanos += elapsed;
+    auto existing = lookup.find(key);
+    if (existing != lookup.end()) {
+        erase(existing->second);
+    }
+    if (!compressed || weight > maxBytes) {
+        stats.incompressible++;
+        if (overflow) {
+            overflow(key, value);
+        }
+        return;
+    }
+    shrinkTo(maxBytes - weight);
+    entries.push_front(Entry{key, std::move(packed), encoded.size(), weight});
+    lookup[key] = entries.begin();
+    currentBytes += weight;
+    rawBytes += encoded.size();
+    stats.stored++;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> CompressedTier<Key, Value>::take(const Key& key) {
+    EntryList taken;
+    {
+        std::lock_guard<std::mutex> lock(tierMutex);
+        auto found = lookup.find(key);
+        if (found == lookup.end()) {
+            stats.misses++;
+            return std::nullopt;
+        }
+        currentBytes -= found->second->weight;
+        rawBytes -= found->second->rawSize;
+        taken.splice(taken.begin(), entries, found->second);
+        lookup.erase(found);
+        stats.hits++;
+    }
+
+    // Decompress without the lock
+    auto start = std::chrono::steady_clock::now();
+    auto value = unpack(taken.front());
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(tierMutex);
+    stats.decompressNanos += elapsed;
+    return value;
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    invalidations++;
+    auto found = lookup.find(key);
+    if (found != lookup.end()) {
+        erase(found->second);
+    }
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::discard(const Key& key) {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    auto found = lookup.find(key);
+    if (found != lookup.end()) {
+        erase(found->second);
+    }
+}
+
+template<typename Key, typename Value>
+size_t CompressedTier<Key, Value>::removeIf(const std::function<bool(const Key&)>& predicate) {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    invalidations++;
+    size_t removed = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto next = std::next(it);
+        if (predicate(it->key)) {
+            erase(it);
+            removed++;
+        }
+        it = next;
+    }
+    return removed;
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    invalidations++;
+    entries.clear();
+    lookup.clear();
+    currentBytes = 0;
+    rawBytes = 0;
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::setCapacity(size_t capacityBytes) {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    maxBytes = capacityBytes;
+    shrinkTo(maxBytes);
+}
+
+template<typename Key, typename Value>
+size_t CompressedTier<Key, Value>::capacity() const {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    return maxBytes;
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::setOverflowListener(OverflowListener listener) {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    overflow = std::move(listener);
+}
+
+template<typename Key, typename Value>
+CompressionStatistics CompressedTier<Key, Value>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    CompressionStatistics statsCopy = stats;
+    statsCopy.residentEntries = lookup.size();
+    statsCopy.residentBytes = currentBytes;
+    statsCopy.rawBytes = rawBytes;
+    statsCopy.updateHitRate();
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::resetStatistics() {
+    std::lock_guard<std::mutex> lock(tierMutex);
+    stats = CompressionStatistics();
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::erase(typename EntryList::iterator it) {
+    currentBytes -= it->weight;
+    rawBytes -= it->rawSize;
+    lookup.erase(it->key);
+    entries.erase(it);
+}
+
+template<typename Key, typename Value>
+void CompressedTier<Key, Value>::shrinkTo(size_t budget) {
+    // Overflow runs under the lock, so once remove() returns no dropped
+    // copy of the key is still on its way to the next tier
+    while (currentBytes > budget && !entries.empty()) {
+        auto oldest = std::prev(entries.end());
+        if (overflow) {
+            if (auto value = unpack(*oldest)) {
+                overflow(oldest->key, *value);
+            }
+        }
+        erase(oldest);
+        stats.dropped++;
+    }
+}
+
+template<typename Key, typename Value>
+std::optional<Value> CompressedTier<Key, Value>::unpack(const Entry& entry) const {
+    std::string encoded;
+    if (!lzDecompress(entry.packed.data(), entry.packed.size(), entry.rawSize, encoded)) {
+        return std::nullopt;
+    }
+    return SpillCodec<Value>::decode(std::move(encoded));
+}
+
+} // namespace mtfs::cache
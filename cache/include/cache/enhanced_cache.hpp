@@ -1,22 +1,99 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <mutex>
+#include <shared_mutex>
 #include <list>
+#include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
+#include <deque>
 #include <chrono>
+#include <algorithm>
+#include <optional>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include "common/error.hpp"
+#include "cache/frequency_sketch.hpp"
+#include "cache/epoch.hpp"
+#include "cache/spill_tier.hpp"
+#include "cache/compressed_tier.hpp"
+#include "cache/heavy_hitters.hpp"
 
 namespace mtfs::cache {
 
+// Immutable, reference-counted byte buffer. Caching these instead of plain
+// strings means a hit hands out a reference rather than a copy of the bytes.
+using Buffer = std::string;
+using SharedBuffer = std::shared_ptr<const Buffer>;
+
+inline SharedBuffer makeSharedBuffer(Buffer data) {
+    return std::make_shared<const Buffer>(std::move(data));
+}
+
+// Reports how many bytes of a cache budget a value occupies. Values without a
+// specialization weigh one unit each, so the budget degrades to an entry count.
+template<typename Value>
+struct ValueWeigher {
+    static size_t weigh(const Value&) { return 1; }
+};
+
+template<>
+struct ValueWeigher<Buffer> {
+    static size_t weigh(const Buffer& value) { return std::max<size_t>(1, value.size()); }
+};
+
+template<>
+struct ValueWeigher<SharedBuffer> {
+    static size_t weigh(const SharedBuffer& value) {
+        return value ? std::max<size_t>(1, value->size()) : 1;
+    }
+};
+
+// Stand-in value held by the shadow caches of PolicyTuner, which only need
+// to know what the real value weighs
+struct ShadowEntry {
+    size_t weight{1};
+};
+
+template<>
+struct ValueWeigher<ShadowEntry> {
+    static size_t weigh(const ShadowEntry& entry) { return entry.weight; }
+};
+
 // Cache policy types
 enum class CachePolicy {
     LRU,  // Least Recently Used
     LFU,  // Least Frequently Used
     FIFO, // First In First Out
-    LIFO  // Last In First Out
+    LIFO, // Last In First Out
+    ARC,  // Adaptive Replacement Cache (scan resistant)
+    CLOCK, // CLOCK approximation of LRU with lock-free hits
+    CLOCK_PRO // CLOCK-Pro on a contiguous slot array (scan resistant)
+};
+
+// Short name as used by the CLI, e.g. "CLOCK_PRO"
+inline const char* policyName(CachePolicy policy) {
+    switch (policy) {
+        case CachePolicy::LRU: return "LRU";
+        case CachePolicy::LFU: return "LFU";
+        case CachePolicy::FIFO: return "FIFO";
+        case CachePolicy::LIFO: return "LIFO";
+        case CachePolicy::ARC: return "ARC";
+        case CachePolicy::CLOCK: return "CLOCK";
+        case CachePolicy::CLOCK_PRO: return "CLOCK_PRO";
+    }
+    return "UNKNOWN";
+}
+
+// Admission filter run in front of the eviction policy
+enum class AdmissionPolicy {
+    None,    // Every new key is inserted
+    TinyLFU  // New keys must be more popular than the entry they would evict
 };
 
 // Cache entry with metadata
@@ -24,6 +101,7 @@ template<typename Key, typename Value>
 struct CacheEntry {
     Key key;
     Value value;
+    size_t weight{1};
     size_t accessCount{0};
     std::chrono::system_clock::time_point lastAccessed;
     std::chrono::system_clock::time_point createdAt;
@@ -33,11 +111,19 @@ struct CacheEntry {
                    createdAt(std::chrono::system_clock::now()) {}
     
     CacheEntry(const Key& k, const Value& v) 
-        : key(k), value(v), 
+        : key(k), value(v), weight(ValueWeigher<Value>::weigh(v)),
           lastAccessed(std::chrono::system_clock::now()),
           createdAt(std::chrono::system_clock::now()) {}
 };
 
+// Key-only view of a resident entry, enough to persist and rebuild the hot set
+template<typename Key>
+struct KeySnapshot {
+    Key key;
+    size_t accessCount{0};
+    bool isPinned{false};
+};
+
 // Cache statistics
 struct CacheStatistics {
     size_t hits{0};
@@ -46,6 +132,10 @@ struct CacheStatistics {
     size_t totalAccesses{0};
     size_t pinnedItems{0};
     size_t prefetchedItems{0};
+    size_t residentBytes{0};
+    size_t bytesEvicted{0};
+    size_t admissionsAccepted{0};  // New keys that won against an eviction victim
+    size_t admissionsRejected{0};  // New keys dropped to protect the victim
     double hitRate{0.0};
     std::chrono::system_clock::time_point lastResetTime;
     
@@ -55,6 +145,21 @@ struct CacheStatistics {
         totalAccesses = hits + misses;
         hitRate = totalAccesses > 0 ? (static_cast<double>(hits) / totalAccesses) * 100.0 : 0.0;
     }
+    
+    // Fold another shard's counters into this one
+    void accumulate(const CacheStatistics& other) {
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+        pinnedItems += other.pinnedItems;
+        prefetchedItems += other.prefetchedItems;
+        residentBytes += other.residentBytes;
+        bytesEvicted += other.bytesEvicted;
+        admissionsAccepted += other.admissionsAccepted;
+        admissionsRejected += other.admissionsRejected;
+        lastResetTime = std::min(lastResetTime, other.lastResetTime);
+        updateHitRate();
+    }
 };
 
 // Base cache interface
@@ -64,11 +169,17 @@ public:
     virtual ~CacheInterface() = default;
     
     virtual void put(const Key& key, const Value& value) = 0;
-    virtual Value get(const Key& key) = 0;
+    // Non-throwing lookup, a miss is reported as std::nullopt
+    virtual std::optional<Value> tryGet(const Key& key) = 0;
+    // Throwing lookup kept for compatibility, implemented on top of tryGet
+    virtual Value get(const Key& key);
     virtual bool contains(const Key& key) const = 0;
     virtual void remove(const Key& key) = 0;
+    // Targeted invalidation, returns how many entries were dropped
+    virtual size_t removeIf(const std::function<bool(const Key&)>& predicate);
     virtual void clear() = 0;
     virtual size_t size() const = 0;
+    // Byte budget, as measured by ValueWeigher
     virtual size_t capacity() const = 0;
     virtual CacheStatistics getStatistics() const = 0;
     virtual void resetStatistics() = 0;
@@ -79,16 +190,44 @@ public:
     virtual bool isPinned(const Key& key) const = 0;
     virtual void prefetch(const Key& key, const Value& value) = 0;
     virtual std::vector<Key> getKeys() const = 0;
+    // Key that would be evicted first to make room for incomingBytes more,
+    // std::nullopt if it already fits or only pinned entries are left
+    virtual std::optional<Key> evictionCandidate(size_t incomingBytes) const = 0;
+    
+    // Migration for policy switches and resizes. drain() removes every
+    // resident entry and returns it in replay order, with accessCount and
+    // isPinned filled in. Passing them to adopt() in that order rebuilds the
+    // same eviction order and evicts only what no longer fits.
+    virtual std::vector<CacheEntry<Key, Value>> drain() = 0;
+    virtual void adopt(CacheEntry<Key, Value> entry) = 0;
+    // Every resident key with its access count and pin, in no particular order
+    virtual std::vector<KeySnapshot<Key>> snapshot() const = 0;
+
+    // Called with every entry the policy evicts to make room, under the
+    // cache lock, so it should only record the entry and leave slow work
+    // to the caller; not called for remove(), clear() or drain()
+    using EvictionListener = std::function<void(const Key&, const Value&)>;
+    void setEvictionListener(EvictionListener listener) { evictionListener = std::move(listener); }
+
+protected:
+    void notifyEviction(const Key& key, const Value& value) const {
+        if (evictionListener) {
+            evictionListener(key, value);
+        }
+    }
+
+private:
+    EvictionListener evictionListener;
 };
 
 // Enhanced LRU Cache
 template<typename Key, typename Value>
 class EnhancedLRUCache : public CacheInterface<Key, Value> {
 public:
-    explicit EnhancedLRUCache(size_t capacity);
+    explicit EnhancedLRUCache(size_t capacityBytes);
     
     void put(const Key& key, const Value& value) override;
-    Value get(const Key& key) override;
+    std::optional<Value> tryGet(const Key& key) override;
     bool contains(const Key& key) const override;
     void remove(const Key& key) override;
     void clear() override;
@@ -103,16 +242,23 @@ public:
     bool isPinned(const Key& key) const override;
     void prefetch(const Key& key, const Value& value) override;
     std::vector<Key> getKeys() const override;
+    std::optional<Key> evictionCandidate(size_t incomingBytes) const override;
+    std::vector<CacheEntry<Key, Value>> drain() override;
+    void adopt(CacheEntry<Key, Value> entry) override;
+    std::vector<KeySnapshot<Key>> snapshot() const override;
 
 private:
     using EntryType = CacheEntry<Key, Value>;
     using EntryList = std::list<EntryType>;
     using EntryMap = std::unordered_map<Key, typename EntryList::iterator>;
     
-    void evict();
+    bool store(const Key& key, const Value& value);
+    bool makeRoom(size_t incomingBytes);
+    bool evict();
     void moveToFront(typename EntryList::iterator it);
     
-    const size_t maxCapacity;
+    const size_t maxBytes;
+    size_t currentBytes{0};
     EntryList entries;
     EntryMap lookup;
     std::unordered_set<Key> pinnedKeys;
@@ -124,10 +270,10 @@ private:
 template<typename Key, typename Value>
 class LFUCache : public CacheInterface<Key, Value> {
 public:
-    explicit LFUCache(size_t capacity);
+    explicit LFUCache(size_t capacityBytes);
     
     void put(const Key& key, const Value& value) override;
-    Value get(const Key& key) override;
+    std::optional<Value> tryGet(const Key& key) override;
     bool contains(const Key& key) const override;
     void remove(const Key& key) override;
     void clear() override;
@@ -142,21 +288,43 @@ public:
     bool isPinned(const Key& key) const override;
     void prefetch(const Key& key, const Value& value) override;
     std::vector<Key> getKeys() const override;
+    std::optional<Key> evictionCandidate(size_t incomingBytes) const override;
+    std::vector<CacheEntry<Key, Value>> drain() override;
+    void adopt(CacheEntry<Key, Value> entry) override;
+    std::vector<KeySnapshot<Key>> snapshot() const override;
 
 private:
     using EntryType = CacheEntry<Key, Value>;
-    using FrequencyMap = std::unordered_map<size_t, std::list<Key>>;
-    using KeyMap = std::unordered_map<Key, EntryType>;
-    using KeyFreqMap = std::unordered_map<Key, size_t>;
-    
-    void evict();
-    void updateFrequency(const Key& key);
-    
-    const size_t maxCapacity;
-    size_t minFrequency{1};
-    FrequencyMap frequencies;
-    KeyMap keyToEntry;
-    KeyFreqMap keyToFreq;
+    using EntryList = std::list<EntryType>;
+    
+    // All entries seen exactly `frequency` times, oldest first. Buckets are
+    // kept in ascending frequency order and empty ones are dropped at once,
+    // so the front bucket always holds the eviction candidates.
+    struct FrequencyBucket {
+        size_t frequency;
+        EntryList entries;
+        explicit FrequencyBucket(size_t freq) : frequency(freq) {}
+    };
+    using BucketList = std::list<FrequencyBucket>;
+    
+    // One node per key: the entry lives in its bucket, the map only keeps
+    // iterators to it, so every move between buckets is a splice
+    struct Position {
+        typename BucketList::iterator bucket;
+        typename EntryList::iterator entry;
+    };
+    using KeyMap = std::unordered_map<Key, Position>;
+    
+    bool store(const Key& key, const Value& value);
+    bool makeRoom(size_t incomingBytes);
+    bool evict();
+    void updateFrequency(Position& position);
+    void unlink(typename KeyMap::iterator it);
+    
+    const size_t maxBytes;
+    size_t currentBytes{0};
+    BucketList buckets;
+    KeyMap lookup;
     std::unordered_set<Key> pinnedKeys;
     mutable std::mutex cacheMutex;
     mutable CacheStatistics stats;
@@ -166,10 +334,104 @@ private:
 template<typename Key, typename Value>
 class FIFOCache : public CacheInterface<Key, Value> {
 public:
-    explicit FIFOCache(size_t capacity);
+    explicit FIFOCache(size_t capacityBytes);
+    
+    void put(const Key& key, const Value& value) override;
+    std::optional<Value> tryGet(const Key& key) override;
+    bool contains(const Key& key) const override;
+    void remove(const Key& key) override;
+    void clear() override;
+    size_t size() const override;
+    size_t capacity() const override;
+    CacheStatistics getStatistics() const override;
+    void resetStatistics() override;
+    
+    // Enhanced features
+    void pin(const Key& key) override;
+    void unpin(const Key& key) override;
+    bool isPinned(const Key& key) const override;
+    void prefetch(const Key& key, const Value& value) override;
+    std::vector<Key> getKeys() const override;
+    std::optional<Key> evictionCandidate(size_t incomingBytes) const override;
+    std::vector<CacheEntry<Key, Value>> drain() override;
+    void adopt(CacheEntry<Key, Value> entry) override;
+    std::vector<KeySnapshot<Key>> snapshot() const override;
+
+private:
+    using EntryType = CacheEntry<Key, Value>;
+    using EntryList = std::list<EntryType>;  // front is the oldest insertion
+    using EntryMap = std::unordered_map<Key, typename EntryList::iterator>;
+    
+    bool store(const Key& key, const Value& value);
+    bool makeRoom(size_t incomingBytes);
+    bool evict();
+    
+    const size_t maxBytes;
+    size_t currentBytes{0};
+    EntryList entries;
+    EntryMap lookup;
+    std::unordered_set<Key> pinnedKeys;
+    mutable std::mutex cacheMutex;
+    mutable CacheStatistics stats;
+};
+
+// LIFO Cache implementation: evicts the most recently inserted entry, so
+// whatever was loaded first stays resident. Reads do not reorder entries.
+template<typename Key, typename Value>
+class LIFOCache : public CacheInterface<Key, Value> {
+public:
+    explicit LIFOCache(size_t capacityBytes);
+    
+    void put(const Key& key, const Value& value) override;
+    std::optional<Value> tryGet(const Key& key) override;
+    bool contains(const Key& key) const override;
+    void remove(const Key& key) override;
+    void clear() override;
+    size_t size() const override;
+    size_t capacity() const override;
+    CacheStatistics getStatistics() const override;
+    void resetStatistics() override;
+    
+    // Enhanced features
+    void pin(const Key& key) override;
+    void unpin(const Key& key) override;
+    bool isPinned(const Key& key) const override;
+    void prefetch(const Key& key, const Value& value) override;
+    std::vector<Key> getKeys() const override;
+    std::optional<Key> evictionCandidate(size_t incomingBytes) const override;
+    std::vector<CacheEntry<Key, Value>> drain() override;
+    void adopt(CacheEntry<Key, Value> entry) override;
+    std::vector<KeySnapshot<Key>> snapshot() const override;
+
+private:
+    using EntryType = CacheEntry<Key, Value>;
+    using EntryList = std::list<EntryType>;  // front is the top of the stack
+    using EntryMap = std::unordered_map<Key, typename EntryList::iterator>;
+    
+    bool store(const Key& key, const Value& value);
+    bool makeRoom(size_t incomingBytes);
+    bool evict();
+    
+    const size_t maxBytes;
+    size_t currentBytes{0};
+    EntryList entries;
+    EntryMap lookup;
+    std::unordered_set<Key> pinnedKeys;
+    mutable std::mutex cacheMutex;
+    mutable CacheStatistics stats;
+};
+
+// Adaptive Replacement Cache. Resident entries live in T1 (seen once) or T2
+// (seen again); B1/B2 remember the keys recently evicted from each. Ghost hits
+// move the T1 target size p, so one-pass scans only churn T1 while the reused
+// working set stays resident in T2. All sizes are in bytes (ValueWeigher).
+template<typename Key, typename Value>
+class ARCCache : public CacheInterface<Key, Value> {
+public:
+    explicit ARCCache(size_t capacityBytes);
     
     void put(const Key& key, const Value& value) override;
-    Value get(const Key& key) override;
+    std::optional<Value> tryGet(const Key& key) override;
     bool contains(const Key& key) const override;
     void remove(const Key& key) override;
     void clear() override;
@@ -184,39 +446,375 @@ public:
     bool isPinned(const Key& key) const override;
     void prefetch(const Key& key, const Value& value) override;
     std::vector<Key> getKeys() const override;
+    std::optional<Key> evictionCandidate(size_t incomingBytes) const override;
+    std::vector<CacheEntry<Key, Value>> drain() override;
+    void adopt(CacheEntry<Key, Value> entry) override;
+    std::vector<KeySnapshot<Key>> snapshot() const override;
 
 private:
+    enum class Segment { T1, T2, B1, B2 };
+    
     using EntryType = CacheEntry<Key, Value>;
-    using EntryQueue = std::queue<Key>;
-    using EntryMap = std::unordered_map<Key, EntryType>;
+    using EntryList = std::list<EntryType>;
+    using GhostList = std::list<std::pair<Key, size_t>>;  // key, weight
+    
+    struct Location {
+        Segment segment;
+        typename EntryList::iterator entry;
+        typename GhostList::iterator ghost;
+    };
     
-    void evict();
+    bool store(const Key& key, const Value& value, bool promote);
+    bool replace(size_t incomingBytes, bool ghostHitInB2);
+    bool evictFrom(Segment segment);
+    void trimGhosts();
+    void dropGhost(Segment segment);
+    void erase(typename std::unordered_map<Key, Location>::iterator it);
+    EntryList& residentList(Segment segment);
+    GhostList& ghostList(Segment segment);
+    size_t& segmentBytes(Segment segment);
     
-    const size_t maxCapacity;
-    EntryQueue insertionOrder;
-    EntryMap entries;
+    const size_t maxBytes;
+    size_t targetT1Bytes{0};  // ARC's adaptive parameter p
+    size_t t1Bytes{0};
+    size_t t2Bytes{0};
+    size_t b1Bytes{0};
+    size_t b2Bytes{0};
+    EntryList t1;
+    EntryList t2;
+    GhostList b1;
+    GhostList b2;
+    std::unordered_map<Key, Location> lookup;
     std::unordered_set<Key> pinnedKeys;
     mutable std::mutex cacheMutex;
     mutable CacheStatistics stats;
 };
 
-// Cache manager to handle different policies
+// Read-optimized CLOCK cache. Hits never take a lock: lookups walk a chained
+// hash table whose nodes are immutable once published, and recency is a
+// reference bit set on the node instead of a list splice. Writers are
+// serialized by cacheMutex, replace nodes rather than modify them, and free
+// unlinked nodes only after an epoch synchronize(). Eviction sweeps the
+// clock hand over the resident nodes, clearing reference bits and taking
+// the first unreferenced, unpinned one. accessCount is approximate: a hit
+// only counts when it finds the reference bit clear, about once per sweep.
+template<typename Key, typename Value>
+class ClockCache : public CacheInterface<Key, Value> {
+public:
+    explicit ClockCache(size_t capacityBytes);
+    ~ClockCache() override;
+    
+    void put(const Key& key, const Value& value) override;
+    std::optional<Value> tryGet(const Key& key) override;
+    bool contains(const Key& key) const override;
+    void remove(const Key& key) override;
+    void clear() override;
+    size_t size() const override;
+    size_t capacity() const override;
+    CacheStatistics getStatistics() const override;
+    void resetStatistics() override;
+    
+    // Enhanced features
+    void pin(const Key& key) override;
+    void unpin(const Key& key) override;
+    bool isPinned(const Key& key) const override;
+    void prefetch(const Key& key, const Value& value) override;
+    std::vector<Key> getKeys() const override;
+    std::optional<Key> evictionCandidate(size_t incomingBytes) const override;
+    std::vector<CacheEntry<Key, Value>> drain() override;
+    void adopt(CacheEntry<Key, Value> entry) override;
+    std::vector<KeySnapshot<Key>> snapshot() const override;
+
+private:
+    struct Node {
+        Node(const Key& key, size_t hash, const Value& value)
+            : key(key), hash(hash), value(value), weight(ValueWeigher<Value>::weigh(value)) {}
+        
+        const Key key;
+        const size_t hash;
+        const Value value;
+        const size_t weight;
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> referenced{false};
+        std::atomic<size_t> accessCount{0};
+        size_t ringIndex{0};  // Writer-only position in the clock ring
+    };
+    
+    struct Table {
+        explicit Table(size_t bucketCount)
+            : mask(bucketCount - 1), buckets(new std::atomic<Node*>[bucketCount]) {
+            for (size_t i = 0; i < bucketCount; ++i) {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        
+        const size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+    };
+    
+    // Hit/miss counters, one cache line per reader slot
+    struct alignas(64) ReaderCounters {
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+    };
+    
+    static constexpr size_t INITIAL_BUCKETS = 64;
+    static constexpr size_t RETIRE_BATCH = 64;  // Unlinked nodes freed per synchronize()
+    
+    Node* find(const Key& key, size_t hash) const;
+    bool store(const Key& key, const Value& value, size_t accessCount, bool referenced);
+    void link(Node* node);
+    void unlink(Node* node);
+    void removeNode(Node* node);
+    void retire(Node* node);
+    void reclaim();
+    void grow();
+    bool makeRoom(size_t incomingBytes);
+    bool evict();
+    void clearLocked();
+    
+    const size_t maxBytes;
+    size_t currentBytes{0};
+    std::atomic<Table*> table;
+    std::vector<Node*> ring;  // Resident nodes in clock order
+    size_t hand{0};
+    std::vector<Node*> retiredNodes;
+    std::vector<std::unique_ptr<Table>> retiredTables;
+    std::unordered_set<Key> pinnedKeys;
+    std::hash<Key> hasher;
+    mutable EpochDomain epoch;
+    mutable ReaderCounters readerCounters[EpochDomain::SLOTS];
+    mutable std::mutex cacheMutex;  // Serializes writers only
+    mutable CacheStatistics stats;  // Writer-side counters
+};
+
+// CLOCK-Pro (Jiang, Chen & Zhang). Resident entries are hot or cold; a cold
+// entry that is evicted stays behind as a non-resident test entry, and a
+// miss on it during its test period brings it back hot and grows the cold
+// target. Three hands sweep one circular list: the cold hand promotes
+// referenced cold entries and evicts the rest, the hot hand demotes, the
+// test hand ends test periods. All entries live in one slot vector linked by
+// 32-bit indices and are found through an open-addressed (linear probing)
+// index, so a hit is a probe plus a reference bit: no list splice, no
+// allocation and no clock read. All sizes are in bytes (ValueWeigher).
+template<typename Key, typename Value>
+class ClockProCache : public CacheInterface<Key, Value> {
+public:
+    explicit ClockProCache(size_t capacityBytes);
+    
+    void put(const Key& key, const Value& value) override;
+    std::optional<Value> tryGet(const Key& key) override;
+    bool contains(const Key& key) const override;
+    void remove(const Key& key) override;
+    void clear() override;
+    size_t size() const override;
+    size_t capacity() const override;
+    CacheStatistics getStatistics() const override;
+    void resetStatistics() override;
+    
+    // Enhanced features
+    void pin(const Key& key) override;
+    void unpin(const Key& key) override;
+    bool isPinned(const Key& key) const override;
+    void prefetch(const Key& key, const Value& value) override;
+    std::vector<Key> getKeys() const override;
+    std::optional<Key> evictionCandidate(size_t incomingBytes) const override;
+    std::vector<CacheEntry<Key, Value>> drain() override;
+    void adopt(CacheEntry<Key, Value> entry) override;
+    std::vector<KeySnapshot<Key>> snapshot() const override;
+
+private:
+    enum class SlotState : uint8_t { Free, Hot, Cold, Test };
+    
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+    
+    struct Slot {
+        Key key;
+        std::optional<Value> value;  // Empty for test entries
+        size_t hash{0};
+        size_t weight{0};
+        size_t accessCount{0};
+        uint32_t prev{NIL};
+        uint32_t next{NIL};
+        SlotState state{SlotState::Free};
+        bool referenced{false};
+        bool pinned{false};
+    };
+    
+    static constexpr size_t INITIAL_BUCKETS = 64;
+    static constexpr size_t MIN_COLD_SHARE = 100;  // Cold target floor: 1% of the budget
+    
+    size_t hashOf(const Key& key) const;
+    size_t home(size_t hash) const;
+    uint32_t find(const Key& key, size_t hash) const;
+    bool isResident(uint32_t index) const;
+    void indexInsert(uint32_t index);
+    void indexErase(uint32_t index);
+    void growIndex();
+    bool store(const Key& key, const Value& value, size_t accessCount, bool referenced);
+    uint32_t allocate(const Key& key, size_t hash);
+    void link(uint32_t index);
+    void erase(uint32_t index);
+    bool makeRoom(size_t incomingBytes);
+    bool runHandCold();
+    void runHandHot();
+    void runHandTest();
+    void clearLocked();
+    
+    const size_t maxBytes;
+    const size_t minColdBytes;
+    size_t coldTargetBytes;  // CLOCK-Pro's adaptive cold allocation m_c
+    size_t hotBytes{0};
+    size_t coldBytes{0};
+    size_t testBytes{0};     // Weight the test entries had while resident
+    size_t residentCount{0};
+    size_t ringSize{0};      // Resident plus test entries
+    size_t pinnedCount{0};
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> buckets;  // Slot index per bucket, NIL when empty
+    size_t indexShift;
+    uint32_t handHot{NIL};
+    uint32_t handCold{NIL};
+    uint32_t handTest{NIL};
+    std::hash<Key> hasher;
+    mutable std::mutex cacheMutex;
+    mutable CacheStatistics stats;
+};
+
+// A new policy instance of the given kind
+template<typename Key, typename Value>
+std::unique_ptr<CacheInterface<Key, Value>> makePolicyCache(CachePolicy policy, size_t capacityBytes);
+
+// Hit rate a shadow cache of one policy reached in the last tuning window
+struct PolicyEstimate {
+    CachePolicy policy{CachePolicy::LRU};
+    double hitRate{0.0};
+};
+
+struct TuningStatistics {
+    bool enabled{false};
+    CachePolicy livePolicy{CachePolicy::LRU};
+    size_t sampleRate{1};   // One key in sampleRate is simulated
+    size_t evaluations{0};  // Complete windows compared
+    size_t switches{0};
+    std::vector<PolicyEstimate> estimates;  // Last window, live policy included
+};
+
+// Miniature simulation behind CacheManager::optimizeForWorkload(). Keys
+// whose hash falls in a 1/sampleRate slice are replayed against shadow
+// caches of LRU, LFU, FIFO and ARC (plus the live policy if it is another
+// one), each sized 1/sampleRate of the budget and holding only weights.
+// After every window of sampled lookups the shadows' hit rates are
+// compared. A policy has to beat the live one by SWITCH_MARGIN points in
+// CONFIRM_WINDOWS windows in a row to be picked, and no switch follows
+// another within COOLDOWN_WINDOWS windows, so near ties do not flap.
+template<typename Key, typename Value>
+class PolicyTuner {
+public:
+    PolicyTuner(CachePolicy livePolicy, size_t capacityBytes);
+    
+    PolicyTuner(const PolicyTuner&) = delete;
+    PolicyTuner& operator=(const PolicyTuner&) = delete;
+    
+    // Replay a lookup and its result; returns true once per complete
+    // window, when the caller should run evaluate()
+    bool recordLookup(const Key& key, const std::optional<Value>& value);
+    void recordInsert(const Key& key, const Value& value);
+    // Follow a policy change or resize of the real cache
+    void reconfigure(CachePolicy livePolicy, size_t capacityBytes);
+    // Close the window; returns the policy to switch to, if any
+    std::optional<CachePolicy> evaluate();
+    TuningStatistics getStatistics() const;
+    
+    static constexpr size_t WINDOW_SAMPLES = 2000;
+    static constexpr double SWITCH_MARGIN = 5.0;  // Hit rate points
+    static constexpr size_t CONFIRM_WINDOWS = 2;
+    static constexpr size_t COOLDOWN_WINDOWS = 4;
+
+private:
+    static constexpr size_t MIN_SHADOW_CAPACITY = 64 * 1024;  // Budget units per shadow
+    static constexpr size_t MAX_SAMPLE_RATE = 64;
+    
+    struct Shadow {
+        CachePolicy policy;
+        std::unique_ptr<CacheInterface<Key, ShadowEntry>> cache;
+        size_t hits{0};
+        size_t misses{0};
+    };
+    
+    bool sampled(const Key& key) const;
+    void rebuildShadows();
+    void resetWindow();
+    
+    std::vector<Shadow> shadows;
+    CachePolicy livePolicy;
+    size_t capacityBytes;
+    size_t sampleRate{1};
+    size_t windowLookups{0};
+    bool evaluationDue{false};
+    std::optional<CachePolicy> leader;  // Candidate ahead of the live policy
+    size_t leaderWindows{0};
+    size_t cooldown{0};
+    size_t evaluations{0};
+    size_t switches{0};
+    std::vector<PolicyEstimate> lastEstimates;
+    std::hash<Key> hasher;
+    mutable std::mutex tunerMutex;
+};
+
+// Cache manager to handle different policies.
+// With shardCount > 1 keys are hashed onto independent policy instances, each
+// with its own lock, eviction and statistics, so concurrent hits on different
+// shards never contend. The manager lock is only taken exclusively when the
+// shard set itself is rebuilt (policy change or resize). Capacity is a byte
+// budget (see ValueWeigher) split evenly across the shards.
 template<typename Key, typename Value>
 class CacheManager {
 public:
-    explicit CacheManager(size_t capacity, CachePolicy policy = CachePolicy::LRU);
+    explicit CacheManager(size_t capacityBytes, CachePolicy policy = CachePolicy::LRU,
+                          size_t shardCount = 1);
     
     // Cache operations
     void put(const Key& key, const Value& value);
+    std::optional<Value> tryGet(const Key& key);
     Value get(const Key& key);
     bool contains(const Key& key) const;
     void remove(const Key& key);
+    size_t removeIf(const std::function<bool(const Key&)>& predicate);
     void clear();
+    size_t size() const;
+    size_t capacity() const;
     
     // Cache management
     void setPolicy(CachePolicy policy);
     CachePolicy getPolicy() const;
-    void resize(size_t newCapacity);
+    void resize(size_t newCapacityBytes);
+    size_t getShardCount() const;
+    void setAdmissionPolicy(AdmissionPolicy policy);
+    AdmissionPolicy getAdmissionPolicy() const;
+    
+    // Second tier on local disk: entries the shards evict are spilled to
+    // path and a memory miss that finds them there moves them back.
+    // contains() and size() only look at memory.
+    void enableSpillTier(const std::string& path, size_t capacityBytes);
+    void disableSpillTier();
+    bool hasSpillTier() const;
+    SpillStatistics getSpillStatistics() const;
+    // Compressed cold tier: compressedShare of the byte budget holds
+    // evicted entries compressed, the shards get the rest. Sits between
+    // the shards and the spill tier.
+    void enableCompression(double compressedShare);
+    void disableCompression();
+    bool hasCompression() const;
+    CompressionStatistics getCompressionStatistics() const;
+    // Shadow simulation of the other policies on sampled traffic; with it
+    // enabled optimizeForWorkload() runs after every tuning window and
+    // switches the live policy when another one clearly does better
+    void enableAutoTuning();
+    void disableAutoTuning();
+    bool hasAutoTuning() const;
+    TuningStatistics getTuningStatistics() const;
     
     // Enhanced features
     void pin(const Key& key);
@@ -228,19 +826,113 @@ public:
     CacheStatistics getStatistics() const;
     void resetStatistics();
     void showCacheAnalytics() const;
+    // Most accessed keys by recent lookups, hottest first. Resident or
+    // not: a hot key that was evicted is a candidate for prefetching.
     std::vector<Key> getHotKeys(size_t count = 10) const;
+    std::vector<HotKey<Key>> getHotKeyCounts(size_t count = 10) const;
+    // Stop ranking a key, e.g. a deleted file
+    void forgetHotKey(const Key& key);
+    // Up to maxEntries resident keys for a warm-start snapshot, pinned keys
+    // first, then by descending access count
+    std::vector<KeySnapshot<Key>> snapshotHotKeys(size_t maxEntries) const;
     
     // Maintenance
     void warmup(const std::vector<std::pair<Key, Value>>& data);
+    // Restore entries with their access counts and pins, e.g. from a
+    // snapshot; keys already resident keep their current value
+    void warmup(std::vector<CacheEntry<Key, Value>> entries);
+    // Compare the shadow policies over the last window and switch to a
+    // clearly better one; runs by itself when auto-tuning is enabled
     void optimizeForWorkload();
 
 private:
+    using CachePtr = std::unique_ptr<CacheInterface<Key, Value>>;
+    
+    // Per-shard TinyLFU state. It has its own lock so recording an access
+    // never waits on the shard, and a contended hit may skip recording.
+    struct AdmissionFilter {
+        std::mutex mutex;
+        FrequencySketch<Key> sketch;
+        size_t accepted{0};
+        size_t rejected{0};
+    };
+    using FilterPtr = std::unique_ptr<AdmissionFilter>;
+    
+    // Shards report evictions while they hold their lock, so the listener
+    // only queues the victim on the calling thread; after the shard call
+    // returns, flushEvictions() compresses or spills it. The first tier's
+    // invalidation count at eviction time shows whether a remove() ran in
+    // between, in which case the victim is dropped.
+    struct Victim {
+        const CacheManager* owner;
+        Key key;
+        Value value;
+        uint64_t invalidations;
+    };
+    static std::vector<Victim>& pendingVictims();
+    
+    // Lookups are counted in the stripe of the calling thread, so threads
+    // hitting the same hot key do not fight over one counter
+    struct alignas(64) HotKeyStripe {
+        std::mutex mutex;
+        HeavyHitters<Key> hitters;
+    };
+    static constexpr size_t HOT_KEY_STRIPES = 16;
+    static constexpr uint32_t HOT_KEY_SAMPLE = 4;
+    
+    // Shards and filters as seen by tryGet() and contains(), which read it
+    // under an epoch guard instead of managerMutex. Anything that replaces
+    // shards or filters retracts it first and publishes a new one after.
+    struct ReadView {
+        std::vector<CacheInterface<Key, Value>*> shards;
+        std::vector<AdmissionFilter*> filters;  // Empty without admission
+        CompressedTier<Key, Value>* compressed{nullptr};
+        SpillTier<Key, Value>* spill{nullptr};
+        PolicyTuner<Key, Value>* tuner{nullptr};
+    };
+    
+    // tryGet() without the tuning step; sets tuningDue when a window is complete
+    std::optional<Value> lookup(const Key& key, bool& tuningDue);
     void recreateCache();
+    void recreateAdmissionFilters();
+    void publishReadView();
+    void retractReadView();
+    size_t shardIndex(const Key& key) const;
+    size_t shardIndex(const Key& key, size_t shardCount) const;
+    CacheInterface<Key, Value>& shardFor(const Key& key) const;
+    void recordAccess(AdmissionFilter& filter, const Key& key);
+    void recordLookup(const Key& key);
+    bool admit(size_t index, const Key& key, const Value& value);
+    size_t compressedCapacity() const;
+    void installEvictionListeners();
+    // Move the victims this thread's shard calls queued down to the tiers
+    void flushEvictions(CompressedTier<Key, Value>* compressed, SpillTier<Key, Value>* spill);
+    // Lower tiers in lookup order: compressed, then spill
+    std::optional<Value> promoteFromTiers(CompressedTier<Key, Value>* compressed, SpillTier<Key, Value>* spill,
+                                          CacheInterface<Key, Value>& shard, const Key& key);
+    template<typename Tier>
+    std::optional<Value> promote(Tier& tier, CacheInterface<Key, Value>& shard, const Key& key);
+    void discardFromTiers(const Key& key);
+    void invalidateTiers(const Key& key);
+    size_t invalidateTiersIf(const std::function<bool(const Key&)>& predicate);
     
     size_t cacheCapacity;
     CachePolicy currentPolicy;
-    std::unique_ptr<CacheInterface<Key, Value>> cache;
-    mutable std::mutex managerMutex;
+    AdmissionPolicy admissionPolicy{AdmissionPolicy::None};
+    size_t requestedShards;
+    std::vector<CachePtr> shards;
+    std::vector<FilterPtr> admissionFilters;
+    CacheStatistics retiredStats;  // Counters of shards replaced by recreateCache
+    std::unique_ptr<CompressedTier<Key, Value>> compressedTier;
+    double compressedShare{0.0};
+    std::unique_ptr<SpillTier<Key, Value>> spillTier;
+    std::unique_ptr<PolicyTuner<Key, Value>> policyTuner;
+    mutable HotKeyStripe hotKeyStripes[HOT_KEY_STRIPES];
+    std::hash<Key> hasher;
+    mutable std::shared_mutex managerMutex;
+    std::unique_ptr<ReadView> currentView;
+    std::atomic<ReadView*> readView{nullptr};
+    mutable EpochDomain readEpoch;
 };
 
 } // namespace mtfs::cache
@@ -7,43 +7,50 @@
 
 namespace mtfs::cache {
 
+// ===== CacheInterface Implementation =====
+
+template<typename Key, typename Value>
+Value CacheInterface<Key, Value>::get(const Key& key) {
+    auto value = tryGet(key);
+    if (!value) {
+        throw std::runtime_error("Key not found in cache");
+    }
+    return std::move(*value);
+}
+
+template<typename Key, typename Value>
+size_t CacheInterface<Key, Value>::removeIf(const std::function<bool(const Key&)>& predicate) {
+    size_t removed = 0;
+    for (const auto& key : getKeys()) {
+        if (predicate(key)) {
+            remove(key);
+            removed++;
+        }
+    }
+    return removed;
+}
+
 // ===== EnhancedLRUCache Implementation =====
 
 template<typename Key, typename Value>
-EnhancedLRUCache<Key, Value>::EnhancedLRUCache(size_t capacity) 
-    : maxCapacity(capacity) {}
+EnhancedLRUCache<Key, Value>::EnhancedLRUCache(size_t capacityBytes) 
+    : maxBytes(capacityBytes) {}
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::put(const Key& key, const Value& value) {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    auto it = lookup.find(key);
-    if (it != lookup.end()) {
-        // Update existing entry
-        it->second->value = value;
-        it->second->lastAccessed = std::chrono::system_clock::now();
-        moveToFront(it->second);
-        return;
-    }
-    
-    // Add new entry
-    if (entries.size() >= maxCapacity) {
-        evict();
-    }
-    
-    entries.emplace_front(key, value);
-    lookup[key] = entries.begin();
+    store(key, value);
 }
 
 template<typename Key, typename Value>
-Value EnhancedLRUCache<Key, Value>::get(const Key& key) {
+std::optional<Value> EnhancedLRUCache<Key, Value>::tryGet(const Key& key) {
     std::lock_guard<std::mutex> lock(cacheMutex);
     
     auto it = lookup.find(key);
     if (it == lookup.end()) {
         stats.misses++;
         stats.updateHitRate();
-        throw std::runtime_error("Key not found in cache");
+        return std::nullopt;
     }
     
     // Update access info
@@ -68,6 +75,7 @@ void EnhancedLRUCache<Key, Value>::remove(const Key& key) {
     
     auto it = lookup.find(key);
     if (it != lookup.end()) {
+        currentBytes -= it->second->weight;
         entries.erase(it->second);
         lookup.erase(it);
         pinnedKeys.erase(key);
@@ -80,6 +88,7 @@ void EnhancedLRUCache<Key, Value>::clear() {
     entries.clear();
     lookup.clear();
     pinnedKeys.clear();
+    currentBytes = 0;
 }
 
 template<typename Key, typename Value>
@@ -90,7 +99,7 @@ size_t EnhancedLRUCache<Key, Value>::size() const {
 
 template<typename Key, typename Value>
 size_t EnhancedLRUCache<Key, Value>::capacity() const {
-    return maxCapacity;
+    return maxBytes;
 }
 
 template<typename Key, typename Value>
@@ -98,6 +107,7 @@ CacheStatistics EnhancedLRUCache<Key, Value>::getStatistics() const {
     std::lock_guard<std::mutex> lock(cacheMutex);
     auto statsCopy = stats;
     statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.residentBytes = currentBytes;
     return statsCopy;
 }
 
@@ -130,26 +140,7 @@ bool EnhancedLRUCache<Key, Value>::isPinned(const Key& key) const {
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::prefetch(const Key& key, const Value& value) {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    if (lookup.find(key) == lookup.end()) {
-        // Key doesn't exist, add it if there's space
-        if (entries.size() < maxCapacity) {
-            entries.emplace_front(key, value);
-            lookup[key] = entries.begin();
-            stats.prefetchedItems++;
-        } else {
-            // Need to evict, but treat as prefetch
-            evict();
-            entries.emplace_front(key, value);
-            lookup[key] = entries.begin();
-            stats.prefetchedItems++;
-        }
-    } else {
-        // Key exists, update value and count as prefetch
-        auto it = lookup.find(key);
-        it->second->value = value;
-        it->second->lastAccessed = std::chrono::system_clock::now();
-        moveToFront(it->second);
+    if (store(key, value)) {
         stats.prefetchedItems++;
     }
 }
@@ -165,20 +156,126 @@ std::vector<Key> EnhancedLRUCache<Key, Value>::getKeys() const {
 }
 
 template<typename Key, typename Value>
-void EnhancedLRUCache<Key, Value>::evict() {
-    while (!entries.empty()) {
+std::optional<Key> EnhancedLRUCache<Key, Value>::evictionCandidate(size_t incomingBytes) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (currentBytes + incomingBytes <= maxBytes) {
+        return std::nullopt;
+    }
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (pinnedKeys.find(it->key) == pinnedKeys.end()) {
+            return it->key;
+        }
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value>
+std::vector<CacheEntry<Key, Value>> EnhancedLRUCache<Key, Value>::drain() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<EntryType> drained;
+    drained.reserve(entries.size());
+    // Least recently used first
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        it->isPinned = pinnedKeys.find(it->key) != pinnedKeys.end();
+        drained.push_back(std::move(*it));
+    }
+    entries.clear();
+    lookup.clear();
+    pinnedKeys.clear();
+    currentBytes = 0;
+    return drained;
+}
+
+template<typename Key, typename Value>
+std::vector<KeySnapshot<Key>> EnhancedLRUCache<Key, Value>::snapshot() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<KeySnapshot<Key>> keys;
+    keys.reserve(entries.size());
+    for (const auto& entry : entries) {
+        keys.push_back({entry.key, entry.accessCount, pinnedKeys.find(entry.key) != pinnedKeys.end()});
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+void EnhancedLRUCache<Key, Value>::adopt(CacheEntry<Key, Value> entry) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (entry.weight > maxBytes || lookup.find(entry.key) != lookup.end() ||
+        !makeRoom(entry.weight)) {
+        return;
+    }
+    if (entry.isPinned) {
+        pinnedKeys.insert(entry.key);
+    }
+    currentBytes += entry.weight;
+    entries.push_front(std::move(entry));
+    lookup[entries.front().key] = entries.begin();
+}
+
+template<typename Key, typename Value>
+bool EnhancedLRUCache<Key, Value>::store(const Key& key, const Value& value) {
+    size_t weight = ValueWeigher<Value>::weigh(value);
+    auto it = lookup.find(key);
+    
+    if (weight > maxBytes) {
+        // Can never fit; drop any stale copy rather than keep serving it
+        if (it != lookup.end()) {
+            currentBytes -= it->second->weight;
+            entries.erase(it->second);
+            lookup.erase(it);
+            pinnedKeys.erase(key);
+        }
+        return false;
+    }
+    
+    if (it != lookup.end()) {
+        // Update existing entry
+        currentBytes = currentBytes - it->second->weight + weight;
+        it->second->value = value;
+        it->second->weight = weight;
+        it->second->lastAccessed = std::chrono::system_clock::now();
+        moveToFront(it->second);
+        makeRoom(0);
+        return true;
+    }
+    
+    // Add new entry
+    if (!makeRoom(weight)) {
+        return false;
+    }
+    entries.emplace_front(key, value);
+    lookup[key] = entries.begin();
+    currentBytes += weight;
+    return true;
+}
+
+template<typename Key, typename Value>
+bool EnhancedLRUCache<Key, Value>::makeRoom(size_t incomingBytes) {
+    while (currentBytes + incomingBytes > maxBytes) {
+        if (!evict()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+bool EnhancedLRUCache<Key, Value>::evict() {
+    // Pinned items found at the tail are rotated to the front, at most once each
+    for (size_t scanned = 0; scanned < entries.size(); ++scanned) {
         auto lastIt = std::prev(entries.end());
         if (pinnedKeys.find(lastIt->key) == pinnedKeys.end()) {
+            currentBytes -= lastIt->weight;
+            stats.bytesEvicted += lastIt->weight;
+            stats.evictions++;
+            this->notifyEviction(lastIt->key, lastIt->value);
             lookup.erase(lastIt->key);
             entries.erase(lastIt);
-            stats.evictions++;
-            break;
+            return true;
         }
-        
-        // Move pinned item to front and try next
         moveToFront(lastIt);
-        if (entries.size() <= 1) break; // Prevent infinite loop
     }
+    return false;
 }
 
 template<typename Key, typename Value>
@@ -191,76 +288,49 @@ void EnhancedLRUCache<Key, Value>::moveToFront(typename EntryList::iterator it)
 // ===== LFUCache Implementation =====
 
 template<typename Key, typename Value>
-LFUCache<Key, Value>::LFUCache(size_t capacity) : maxCapacity(capacity) {}
+LFUCache<Key, Value>::LFUCache(size_t capacityBytes) : maxBytes(capacityBytes) {}
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::put(const Key& key, const Value& value) {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    if (maxCapacity == 0) return;
-    
-    auto it = keyToEntry.find(key);
-    if (it != keyToEntry.end()) {
-        // Update existing entry
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
-        updateFrequency(key);
-        return;
-    }
-    
-    // Add new entry
-    if (keyToEntry.size() >= maxCapacity) {
-        evict();
-    }
-    
-    keyToEntry[key] = EntryType(key, value);
-    keyToFreq[key] = 1;
-    frequencies[1].push_back(key);
-    minFrequency = 1;
+    store(key, value);
 }
 
 template<typename Key, typename Value>
-Value LFUCache<Key, Value>::get(const Key& key) {
+std::optional<Value> LFUCache<Key, Value>::tryGet(const Key& key) {
     std::lock_guard<std::mutex> lock(cacheMutex);
     
-    auto it = keyToEntry.find(key);
-    if (it == keyToEntry.end()) {
+    auto it = lookup.find(key);
+    if (it == lookup.end()) {
         stats.misses++;
         stats.updateHitRate();
-        throw std::runtime_error("Key not found in cache");
+        return std::nullopt;
     }
     
     // Update access info
-    it->second.accessCount++;
-    it->second.lastAccessed = std::chrono::system_clock::now();
-    updateFrequency(key);
+    auto entry = it->second.entry;
+    entry->accessCount++;
+    entry->lastAccessed = std::chrono::system_clock::now();
+    updateFrequency(it->second);
     
     stats.hits++;
     stats.updateHitRate();
-    return it->second.value;
+    return entry->value;
 }
 
 template<typename Key, typename Value>
 bool LFUCache<Key, Value>::contains(const Key& key) const {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    return keyToEntry.find(key) != keyToEntry.end();
+    return lookup.find(key) != lookup.end();
 }
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::remove(const Key& key) {
     std::lock_guard<std::mutex> lock(cacheMutex);
     
-    auto it = keyToEntry.find(key);
-    if (it != keyToEntry.end()) {
-        size_t freq = keyToFreq[key];
-        auto& freqList = frequencies[freq];
-        freqList.remove(key);
-        if (freqList.empty() && freq == minFrequency) {
-            minFrequency++;
-        }
-        
-        keyToEntry.erase(key);
-        keyToFreq.erase(key);
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        unlink(it);
         pinnedKeys.erase(key);
     }
 }
@@ -268,22 +338,21 @@ void LFUCache<Key, Value>::remove(const Key& key) {
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::clear() {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    keyToEntry.clear();
-    keyToFreq.clear();
-    frequencies.clear();
+    lookup.clear();
+    buckets.clear();
     pinnedKeys.clear();
-    minFrequency = 1;
+    currentBytes = 0;
 }
 
 template<typename Key, typename Value>
 size_t LFUCache<Key, Value>::size() const {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    return keyToEntry.size();
+    return lookup.size();
 }
 
 template<typename Key, typename Value>
 size_t LFUCache<Key, Value>::capacity() const {
-    return maxCapacity;
+    return maxBytes;
 }
 
 template<typename Key, typename Value>
@@ -291,6 +360,7 @@ CacheStatistics LFUCache<Key, Value>::getStatistics() const {
     std::lock_guard<std::mutex> lock(cacheMutex);
     auto statsCopy = stats;
     statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.residentBytes = currentBytes;
     return statsCopy;
 }
 
@@ -303,7 +373,7 @@ void LFUCache<Key, Value>::resetStatistics() {
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::pin(const Key& key) {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    if (keyToEntry.find(key) != keyToEntry.end()) {
+    if (lookup.find(key) != lookup.end()) {
         pinnedKeys.insert(key);
     }
 }
@@ -323,22 +393,7 @@ bool LFUCache<Key, Value>::isPinned(const Key& key) const {
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::prefetch(const Key& key, const Value& value) {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    auto it = keyToEntry.find(key);
-    if (it == keyToEntry.end()) {
-        // Key doesn't exist, add it
-        if (keyToEntry.size() >= maxCapacity) {
-            evict();
-        }
-        keyToEntry[key] = EntryType(key, value);
-        keyToFreq[key] = 1;
-        frequencies[1].push_back(key);
-        minFrequency = 1;
-        stats.prefetchedItems++;
-    } else {
-        // Key exists, update value and count as prefetch
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
+    if (store(key, value)) {
         stats.prefetchedItems++;
     }
 }
@@ -347,113 +402,239 @@ template<typename Key, typename Value>
 std::vector<Key> LFUCache<Key, Value>::getKeys() const {
     std::lock_guard<std::mutex> lock(cacheMutex);
     std::vector<Key> keys;
-    for (const auto& pair : keyToEntry) {
-        keys.push_back(pair.first);
+    keys.reserve(lookup.size());
+    // Most frequently used first
+    for (auto bucket = buckets.rbegin(); bucket != buckets.rend(); ++bucket) {
+        for (const auto& entry : bucket->entries) {
+            keys.push_back(entry.key);
+        }
     }
     return keys;
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::evict() {
-    // Find least frequent unpinned key
-    for (auto freqIt = frequencies.find(minFrequency); 
-         freqIt != frequencies.end(); ++freqIt) {
-        auto& keyList = freqIt->second;
-        
-        for (auto keyIt = keyList.begin(); keyIt != keyList.end(); ++keyIt) {
-            if (pinnedKeys.find(*keyIt) == pinnedKeys.end()) {
-                Key keyToRemove = *keyIt;
-                keyList.erase(keyIt);
-                keyToEntry.erase(keyToRemove);
-                keyToFreq.erase(keyToRemove);
-                stats.evictions++;
-                
-                if (keyList.empty() && freqIt->first == minFrequency) {
-                    minFrequency++;
-                }
-                return;
+std::optional<Key> LFUCache<Key, Value>::evictionCandidate(size_t incomingBytes) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (currentBytes + incomingBytes <= maxBytes) {
+        return std::nullopt;
+    }
+    // Same walk as evict()
+    for (const auto& bucket : buckets) {
+        for (const auto& entry : bucket.entries) {
+            if (pinnedKeys.find(entry.key) == pinnedKeys.end()) {
+                return entry.key;
             }
         }
     }
+    return std::nullopt;
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::updateFrequency(const Key& key) {
-    size_t oldFreq = keyToFreq[key];
-    size_t newFreq = oldFreq + 1;
-    
-    // Remove from old frequency list
-    frequencies[oldFreq].remove(key);
-    if (frequencies[oldFreq].empty() && oldFreq == minFrequency) {
-        minFrequency++;
+std::vector<CacheEntry<Key, Value>> LFUCache<Key, Value>::drain() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<EntryType> drained;
+    drained.reserve(lookup.size());
+    // Least frequent first, oldest first within a frequency
+    for (auto& bucket : buckets) {
+        for (auto& entry : bucket.entries) {
+            entry.isPinned = pinnedKeys.find(entry.key) != pinnedKeys.end();
+            drained.push_back(std::move(entry));
+        }
     }
-    
-    // Add to new frequency list
-    keyToFreq[key] = newFreq;
-    frequencies[newFreq].push_back(key);
+    buckets.clear();
+    lookup.clear();
+    pinnedKeys.clear();
+    currentBytes = 0;
+    return drained;
 }
 
-// ===== FIFOCache Implementation =====
-
 template<typename Key, typename Value>
-FIFOCache<Key, Value>::FIFOCache(size_t capacity) : maxCapacity(capacity) {}
+std::vector<KeySnapshot<Key>> LFUCache<Key, Value>::snapshot() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<KeySnapshot<Key>> keys;
+    keys.reserve(lookup.size());
+    for (const auto& bucket : buckets) {
+        for (const auto& entry : bucket.entries) {
+            keys.push_back({entry.key, entry.accessCount, pinnedKeys.find(entry.key) != pinnedKeys.end()});
+        }
+    }
+    return keys;
+}
 
 template<typename Key, typename Value>
-void FIFOCache<Key, Value>::put(const Key& key, const Value& value) {
+void LFUCache<Key, Value>::adopt(CacheEntry<Key, Value> entry) {
     std::lock_guard<std::mutex> lock(cacheMutex);
+    if (entry.weight > maxBytes || lookup.find(entry.key) != lookup.end() ||
+        !makeRoom(entry.weight)) {
+        return;
+    }
+    
+    // The insert itself counted as the first use, every hit adds one
+    size_t frequency = entry.accessCount + 1;
+    // Replay arrives in ascending frequency, so the bucket is almost always
+    // the last one
+    auto bucket = buckets.end();
+    while (bucket != buckets.begin() && std::prev(bucket)->frequency > frequency) {
+        --bucket;
+    }
+    if (bucket == buckets.begin() || std::prev(bucket)->frequency != frequency) {
+        bucket = buckets.emplace(bucket, frequency);
+    } else {
+        --bucket;
+    }
+    
+    if (entry.isPinned) {
+        pinnedKeys.insert(entry.key);
+    }
+    currentBytes += entry.weight;
+    bucket->entries.push_back(std::move(entry));
+    auto position = std::prev(bucket->entries.end());
+    lookup[position->key] = Position{bucket, position};
+}
+
+template<typename Key, typename Value>
+bool LFUCache<Key, Value>::store(const Key& key, const Value& value) {
+    if (maxBytes == 0) return false;
+    
+    size_t weight = ValueWeigher<Value>::weigh(value);
+    auto it = lookup.find(key);
     
-    auto it = entries.find(key);
-    if (it != entries.end()) {
+    if (it != lookup.end()) {
+        if (weight > maxBytes) {
+            // Can never fit; drop the stale copy rather than keep serving it
+            unlink(it);
+            pinnedKeys.erase(key);
+            return false;
+        }
+        
         // Update existing entry
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
-        return;
+        auto entry = it->second.entry;
+        currentBytes = currentBytes - entry->weight + weight;
+        entry->value = value;
+        entry->weight = weight;
+        entry->lastAccessed = std::chrono::system_clock::now();
+        updateFrequency(it->second);
+        makeRoom(0);
+        return true;
     }
     
     // Add new entry
-    if (entries.size() >= maxCapacity) {
-        evict();
+    if (weight > maxBytes || !makeRoom(weight)) {
+        return false;
+    }
+    
+    if (buckets.empty() || buckets.front().frequency != 1) {
+        buckets.emplace_front(1);
+    }
+    auto bucket = buckets.begin();
+    bucket->entries.emplace_back(key, value);
+    lookup[key] = Position{bucket, std::prev(bucket->entries.end())};
+    currentBytes += weight;
+    return true;
+}
+
+template<typename Key, typename Value>
+bool LFUCache<Key, Value>::makeRoom(size_t incomingBytes) {
+    while (currentBytes + incomingBytes > maxBytes) {
+        if (!evict()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+bool LFUCache<Key, Value>::evict() {
+    // Least frequent first, oldest first within a frequency; only pinned
+    // entries are ever skipped
+    for (auto& bucket : buckets) {
+        for (auto& entry : bucket.entries) {
+            if (pinnedKeys.find(entry.key) == pinnedKeys.end()) {
+                stats.bytesEvicted += entry.weight;
+                stats.evictions++;
+                this->notifyEviction(entry.key, entry.value);
+                unlink(lookup.find(entry.key));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::updateFrequency(Position& position) {
+    auto current = position.bucket;
+    auto next = std::next(current);
+    if (next == buckets.end() || next->frequency != current->frequency + 1) {
+        next = buckets.emplace(next, current->frequency + 1);
     }
     
-    entries[key] = EntryType(key, value);
-    insertionOrder.push(key);
+    // Splice keeps the entry iterator valid, nothing is copied or searched
+    next->entries.splice(next->entries.end(), current->entries, position.entry);
+    position.bucket = next;
+    if (current->entries.empty()) {
+        buckets.erase(current);
+    }
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::unlink(typename KeyMap::iterator it) {
+    auto bucket = it->second.bucket;
+    currentBytes -= it->second.entry->weight;
+    bucket->entries.erase(it->second.entry);
+    if (bucket->entries.empty()) {
+        buckets.erase(bucket);
+    }
+    lookup.erase(it);
+}
+
+// ===== FIFOCache Implementation =====
+
+template<typename Key, typename Value>
+FIFOCache<Key, Value>::FIFOCache(size_t capacityBytes) : maxBytes(capacityBytes) {}
+
+template<typename Key, typename Value>
+void FIFOCache<Key, Value>::put(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    store(key, value);
 }
 
 template<typename Key, typename Value>
-Value FIFOCache<Key, Value>::get(const Key& key) {
+std::optional<Value> FIFOCache<Key, Value>::tryGet(const Key& key) {
     std::lock_guard<std::mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it == entries.end()) {
+    auto it = lookup.find(key);
+    if (it == lookup.end()) {
         stats.misses++;
         stats.updateHitRate();
-        throw std::runtime_error("Key not found in cache");
+        return std::nullopt;
     }
     
-    // Update access info
-    it->second.accessCount++;
-    it->second.lastAccessed = std::chrono::system_clock::now();
+    // Update access info; the queue position only depends on insertion
+    it->second->accessCount++;
+    it->second->lastAccessed = std::chrono::system_clock::now();
     
     stats.hits++;
     stats.updateHitRate();
-    return it->second.value;
+    return it->second->value;
 }
 
 template<typename Key, typename Value>
 bool FIFOCache<Key, Value>::contains(const Key& key) const {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    return entries.find(key) != entries.end();
+    return lookup.find(key) != lookup.end();
 }
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::remove(const Key& key) {
     std::lock_guard<std::mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it != entries.end()) {
-        entries.erase(it);
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        currentBytes -= it->second->weight;
+        entries.erase(it->second);
+        lookup.erase(it);
         pinnedKeys.erase(key);
-        // Note: Can't efficiently remove from queue, will be handled in evict
     }
 }
 
@@ -461,8 +642,9 @@ template<typename Key, typename Value>
 void FIFOCache<Key, Value>::clear() {
     std::lock_guard<std::mutex> lock(cacheMutex);
     entries.clear();
+    lookup.clear();
     pinnedKeys.clear();
-    insertionOrder = EntryQueue(); // Clear queue
+    currentBytes = 0;
 }
 
 template<typename Key, typename Value>
@@ -473,7 +655,7 @@ size_t FIFOCache<Key, Value>::size() const {
 
 template<typename Key, typename Value>
 size_t FIFOCache<Key, Value>::capacity() const {
-    return maxCapacity;
+    return maxBytes;
 }
 
 template<typename Key, typename Value>
@@ -481,6 +663,7 @@ CacheStatistics FIFOCache<Key, Value>::getStatistics() const {
     std::lock_guard<std::mutex> lock(cacheMutex);
     auto statsCopy = stats;
     statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.residentBytes = currentBytes;
     return statsCopy;
 }
 
@@ -493,7 +676,7 @@ void FIFOCache<Key, Value>::resetStatistics() {
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::pin(const Key& key) {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    if (entries.find(key) != entries.end()) {
+    if (lookup.find(key) != lookup.end()) {
         pinnedKeys.insert(key);
     }
 }
@@ -513,20 +696,7 @@ bool FIFOCache<Key, Value>::isPinned(const Key& key) const {
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::prefetch(const Key& key, const Value& value) {
     std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    auto it = entries.find(key);
-    if (it == entries.end()) {
-        // Key doesn't exist, add it
-        if (entries.size() >= maxCapacity) {
-            evict();
-        }
-        entries[key] = EntryType(key, value);
-        insertionOrder.push(key);
-        stats.prefetchedItems++;
-    } else {
-        // Key exists, update value and count as prefetch
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
+    if (store(key, value)) {
         stats.prefetchedItems++;
     }
 }
@@ -535,124 +705,2243 @@ template<typename Key, typename Value>
 std::vector<Key> FIFOCache<Key, Value>::getKeys() const {
     std::lock_guard<std::mutex> lock(cacheMutex);
     std::vector<Key> keys;
-    for (const auto& pair : entries) {
-        keys.push_back(pair.first);
+    for (const auto& entry : entries) {
+        keys.push_back(entry.key);
     }
     return keys;
 }
 
 template<typename Key, typename Value>
-void FIFOCache<Key, Value>::evict() {
-    while (!insertionOrder.empty()) {
-        Key oldestKey = insertionOrder.front();
-        insertionOrder.pop();
-        
-        // Check if key still exists and is not pinned
-        auto it = entries.find(oldestKey);
-        if (it != entries.end() && pinnedKeys.find(oldestKey) == pinnedKeys.end()) {
-            entries.erase(it);
-            stats.evictions++;
-            break;
+std::optional<Key> FIFOCache<Key, Value>::evictionCandidate(size_t incomingBytes) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (currentBytes + incomingBytes <= maxBytes) {
+        return std::nullopt;
+    }
+    for (const auto& entry : entries) {
+        if (pinnedKeys.find(entry.key) == pinnedKeys.end()) {
+            return entry.key;
         }
     }
+    return std::nullopt;
 }
 
-// ===== CacheManager Implementation =====
-
 template<typename Key, typename Value>
-CacheManager<Key, Value>::CacheManager(size_t capacity, CachePolicy policy) 
-    : cacheCapacity(capacity), currentPolicy(policy) {
-    recreateCache();
+std::vector<CacheEntry<Key, Value>> FIFOCache<Key, Value>::drain() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<EntryType> drained;
+    drained.reserve(entries.size());
+    // Oldest first
+    for (auto& entry : entries) {
+        entry.isPinned = pinnedKeys.find(entry.key) != pinnedKeys.end();
+        drained.push_back(std::move(entry));
+    }
+    entries.clear();
+    lookup.clear();
+    pinnedKeys.clear();
+    currentBytes = 0;
+    return drained;
 }
 
 template<typename Key, typename Value>
-void CacheManager<Key, Value>::put(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    cache->put(key, value);
+std::vector<KeySnapshot<Key>> FIFOCache<Key, Value>::snapshot() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<KeySnapshot<Key>> keys;
+    keys.reserve(entries.size());
+    for (const auto& entry : entries) {
+        keys.push_back({entry.key, entry.accessCount, pinnedKeys.find(entry.key) != pinnedKeys.end()});
+    }
+    return keys;
 }
 
 template<typename Key, typename Value>
-Value CacheManager<Key, Value>::get(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    return cache->get(key);
+void FIFOCache<Key, Value>::adopt(CacheEntry<Key, Value> entry) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (entry.weight > maxBytes || lookup.find(entry.key) != lookup.end() ||
+        !makeRoom(entry.weight)) {
+        return;
+    }
+    if (entry.isPinned) {
+        pinnedKeys.insert(entry.key);
+    }
+    currentBytes += entry.weight;
+    entries.push_back(std::move(entry));
+    lookup[entries.back().key] = std::prev(entries.end());
 }
 
 template<typename Key, typename Value>
-bool CacheManager<Key, Value>::contains(const Key& key) const {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    return cache->contains(key);
+bool FIFOCache<Key, Value>::store(const Key& key, const Value& value) {
+    size_t weight = ValueWeigher<Value>::weigh(value);
+    auto it = lookup.find(key);
+    
+    if (weight > maxBytes) {
+        // Can never fit; drop any stale copy rather than keep serving it
+        if (it != lookup.end()) {
+            currentBytes -= it->second->weight;
+            entries.erase(it->second);
+            lookup.erase(it);
+            pinnedKeys.erase(key);
+        }
+        return false;
+    }
+    
+    if (it != lookup.end()) {
+        // Update existing entry in place, it keeps its queue position
+        currentBytes = currentBytes - it->second->weight + weight;
+        it->second->value = value;
+        it->second->weight = weight;
+        it->second->lastAccessed = std::chrono::system_clock::now();
+        makeRoom(0);
+        return true;
+    }
+    
+    // Add new entry at the back of the queue
+    if (!makeRoom(weight)) {
+        return false;
+    }
+    entries.emplace_back(key, value);
+    lookup[key] = std::prev(entries.end());
+    currentBytes += weight;
+    return true;
 }
 
 template<typename Key, typename Value>
-void CacheManager<Key, Value>::remove(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    cache->remove(key);
+bool FIFOCache<Key, Value>::makeRoom(size_t incomingBytes) {
+    while (currentBytes + incomingBytes > maxBytes) {
+        if (!evict()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 template<typename Key, typename Value>
-void CacheManager<Key, Value>::clear() {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    cache->clear();
+bool FIFOCache<Key, Value>::evict() {
+    // Oldest unpinned entry; pinned ones keep their place in the queue
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (pinnedKeys.find(it->key) == pinnedKeys.end()) {
+            currentBytes -= it->weight;
+            stats.bytesEvicted += it->weight;
+            stats.evictions++;
+            this->notifyEviction(it->key, it->value);
+            lookup.erase(it->key);
+            entries.erase(it);
+            return true;
+        }
+    }
+    return false;
 }
 
+// ===== LIFOCache Implementation =====
+
 template<typename Key, typename Value>
-void CacheManager<Key, Value>::setPolicy(CachePolicy policy) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    if (currentPolicy != policy) {
-        currentPolicy = policy;
-        recreateCache();
-    }
-}
+LIFOCache<Key, Value>::LIFOCache(size_t capacityBytes) : maxBytes(capacityBytes) {}
 
 template<typename Key, typename Value>
-CachePolicy CacheManager<Key, Value>::getPolicy() const {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    return currentPolicy;
+void LIFOCache<Key, Value>::put(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    store(key, value);
 }
 
 template<typename Key, typename Value>
-void CacheManager<Key, Value>::resize(size_t newCapacity) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    if (cacheCapacity != newCapacity) {
-        cacheCapacity = newCapacity;
-        recreateCache();
+std::optional<Value> LIFOCache<Key, Value>::tryGet(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    
+    auto it = lookup.find(key);
+    if (it == lookup.end()) {
+        stats.misses++;
+        stats.updateHitRate();
+        return std::nullopt;
+    }
+    
+    // Update access info; the stack position only depends on insertion
+    it->second->accessCount++;
+    it->second->lastAccessed = std::chrono::system_clock::now();
+    
+    stats.hits++;
+    stats.updateHitRate();
+    return it->second->value;
+}
+
+template<typename Key, typename Value>
+bool LIFOCache<Key, Value>::contains(const Key& key) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return lookup.find(key) != lookup.end();
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        currentBytes -= it->second->weight;
+        entries.erase(it->second);
+        lookup.erase(it);
+        pinnedKeys.erase(key);
+    }
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    entries.clear();
+    lookup.clear();
+    pinnedKeys.clear();
+    currentBytes = 0;
+}
+
+template<typename Key, typename Value>
+size_t LIFOCache<Key, Value>::size() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return entries.size();
+}
+
+template<typename Key, typename Value>
+size_t LIFOCache<Key, Value>::capacity() const {
+    return maxBytes;
+}
+
+template<typename Key, typename Value>
+CacheStatistics LIFOCache<Key, Value>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto statsCopy = stats;
+    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.residentBytes = currentBytes;
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::resetStatistics() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    stats = CacheStatistics();
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::pin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (lookup.find(key) != lookup.end()) {
+        pinnedKeys.insert(key);
+    }
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::unpin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    pinnedKeys.erase(key);
+}
+
+template<typename Key, typename Value>
+bool LIFOCache<Key, Value>::isPinned(const Key& key) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return pinnedKeys.find(key) != pinnedKeys.end();
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::prefetch(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (store(key, value)) {
+        stats.prefetchedItems++;
+    }
+}
+
+template<typename Key, typename Value>
+std::vector<Key> LIFOCache<Key, Value>::getKeys() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<Key> keys;
+    for (const auto& entry : entries) {
+        keys.push_back(entry.key);
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+std::optional<Key> LIFOCache<Key, Value>::evictionCandidate(size_t incomingBytes) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (currentBytes + incomingBytes <= maxBytes) {
+        return std::nullopt;
+    }
+    for (const auto& entry : entries) {
+        if (pinnedKeys.find(entry.key) == pinnedKeys.end()) {
+            return entry.key;
+        }
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value>
+std::vector<CacheEntry<Key, Value>> LIFOCache<Key, Value>::drain() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<EntryType> drained;
+    drained.reserve(entries.size());
+    // Bottom of the stack first
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        it->isPinned = pinnedKeys.find(it->key) != pinnedKeys.end();
+        drained.push_back(std::move(*it));
+    }
+    entries.clear();
+    lookup.clear();
+    pinnedKeys.clear();
+    currentBytes = 0;
+    return drained;
+}
+
+template<typename Key, typename Value>
+std::vector<KeySnapshot<Key>> LIFOCache<Key, Value>::snapshot() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<KeySnapshot<Key>> keys;
+    keys.reserve(entries.size());
+    for (const auto& entry : entries) {
+        keys.push_back({entry.key, entry.accessCount, pinnedKeys.find(entry.key) != pinnedKeys.end()});
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::adopt(CacheEntry<Key, Value> entry) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (entry.weight > maxBytes || lookup.find(entry.key) != lookup.end() ||
+        !makeRoom(entry.weight)) {
+        return;
+    }
+    if (entry.isPinned) {
+        pinnedKeys.insert(entry.key);
+    }
+    currentBytes += entry.weight;
+    entries.push_front(std::move(entry));
+    lookup[entries.front().key] = entries.begin();
+}
+
+template<typename Key, typename Value>
+bool LIFOCache<Key, Value>::store(const Key& key, const Value& value) {
+    size_t weight = ValueWeigher<Value>::weigh(value);
+    auto it = lookup.find(key);
+    
+    if (weight > maxBytes) {
+        // Can never fit; drop any stale copy rather than keep serving it
+        if (it != lookup.end()) {
+            currentBytes -= it->second->weight;
+            entries.erase(it->second);
+            lookup.erase(it);
+            pinnedKeys.erase(key);
+        }
+        return false;
+    }
+    
+    if (it != lookup.end()) {
+        // Update existing entry in place, it keeps its stack position
+        currentBytes = currentBytes - it->second->weight + weight;
+        it->second->value = value;
+        it->second->weight = weight;
+        it->second->lastAccessed = std::chrono::system_clock::now();
+        makeRoom(0);
+        return true;
+    }
+    
+    // Add new entry on top of the stack
+    if (!makeRoom(weight)) {
+        return false;
+    }
+    entries.emplace_front(key, value);
+    lookup[key] = entries.begin();
+    currentBytes += weight;
+    return true;
+}
+
+template<typename Key, typename Value>
+bool LIFOCache<Key, Value>::makeRoom(size_t incomingBytes) {
+    while (currentBytes + incomingBytes > maxBytes) {
+        if (!evict()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+bool LIFOCache<Key, Value>::evict() {
+    // Newest unpinned entry; pinned ones keep their place in the stack
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (pinnedKeys.find(it->key) == pinnedKeys.end()) {
+            currentBytes -= it->weight;
+            stats.bytesEvicted += it->weight;
+            stats.evictions++;
+            this->notifyEviction(it->key, it->value);
+            lookup.erase(it->key);
+            entries.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ===== ARCCache Implementation =====
+
+template<typename Key, typename Value>
+ARCCache<Key, Value>::ARCCache(size_t capacityBytes) : maxBytes(capacityBytes) {}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::put(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    store(key, value, true);
+}
+
+template<typename Key, typename Value>
+std::optional<Value> ARCCache<Key, Value>::tryGet(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    
+    auto it = lookup.find(key);
+    if (it == lookup.end() || it->second.segment == Segment::B1 || it->second.segment == Segment::B2) {
+        stats.misses++;
+        stats.updateHitRate();
+        return std::nullopt;
+    }
+    
+    // Update access info
+    auto entry = it->second.entry;
+    entry->accessCount++;
+    entry->lastAccessed = std::chrono::system_clock::now();
+    
+    // Any re-reference promotes the entry to the MRU end of T2
+    if (it->second.segment == Segment::T1) {
+        t1Bytes -= entry->weight;
+        t2Bytes += entry->weight;
+        t2.splice(t2.begin(), t1, entry);
+        it->second.segment = Segment::T2;
+    } else {
+        t2.splice(t2.begin(), t2, entry);
+    }
+    
+    stats.hits++;
+    stats.updateHitRate();
+    return entry->value;
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::contains(const Key& key) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = lookup.find(key);
+    return it != lookup.end() &&
+           (it->second.segment == Segment::T1 || it->second.segment == Segment::T2);
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        erase(it);
+        pinnedKeys.erase(key);
+    }
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    t1.clear();
+    t2.clear();
+    b1.clear();
+    b2.clear();
+    lookup.clear();
+    pinnedKeys.clear();
+    targetT1Bytes = 0;
+    t1Bytes = t2Bytes = b1Bytes = b2Bytes = 0;
+}
+
+template<typename Key, typename Value>
+size_t ARCCache<Key, Value>::size() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return t1.size() + t2.size();
+}
+
+template<typename Key, typename Value>
+size_t ARCCache<Key, Value>::capacity() const {
+    return maxBytes;
+}
+
+template<typename Key, typename Value>
+CacheStatistics ARCCache<Key, Value>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto statsCopy = stats;
+    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.residentBytes = t1Bytes + t2Bytes;
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::resetStatistics() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    stats = CacheStatistics();
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::pin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = lookup.find(key);
+    if (it != lookup.end() &&
+        (it->second.segment == Segment::T1 || it->second.segment == Segment::T2)) {
+        pinnedKeys.insert(key);
+    }
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::unpin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    pinnedKeys.erase(key);
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::isPinned(const Key& key) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return pinnedKeys.find(key) != pinnedKeys.end();
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::prefetch(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    // Prefetched data has not been referenced yet, so it never promotes to T2
+    if (store(key, value, false)) {
+        stats.prefetchedItems++;
+    }
+}
+
+template<typename Key, typename Value>
+std::vector<Key> ARCCache<Key, Value>::getKeys() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<Key> keys;
+    for (const auto& entry : t2) {
+        keys.push_back(entry.key);
+    }
+    for (const auto& entry : t1) {
+        keys.push_back(entry.key);
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+std::optional<Key> ARCCache<Key, Value>::evictionCandidate(size_t incomingBytes) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (t1Bytes + t2Bytes + incomingBytes <= maxBytes) {
+        return std::nullopt;
+    }
+    // Mirrors replace() for a brand new key
+    bool preferT1 = t1Bytes > 0 && t1Bytes > targetT1Bytes;
+    const EntryList* lists[] = {preferT1 ? &t1 : &t2, preferT1 ? &t2 : &t1};
+    for (const EntryList* list : lists) {
+        for (auto it = list->rbegin(); it != list->rend(); ++it) {
+            if (pinnedKeys.find(it->key) == pinnedKeys.end()) {
+                return it->key;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value>
+std::vector<CacheEntry<Key, Value>> ARCCache<Key, Value>::drain() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<EntryType> drained;
+    drained.reserve(t1.size() + t2.size());
+    // T1 before T2, least recently used first within each; ghosts are dropped
+    for (EntryList* list : {&t1, &t2}) {
+        for (auto it = list->rbegin(); it != list->rend(); ++it) {
+            it->isPinned = pinnedKeys.find(it->key) != pinnedKeys.end();
+            drained.push_back(std::move(*it));
+        }
+    }
+    t1.clear();
+    t2.clear();
+    b1.clear();
+    b2.clear();
+    lookup.clear();
+    pinnedKeys.clear();
+    targetT1Bytes = 0;
+    t1Bytes = t2Bytes = b1Bytes = b2Bytes = 0;
+    return drained;
+}
+
+template<typename Key, typename Value>
+std::vector<KeySnapshot<Key>> ARCCache<Key, Value>::snapshot() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<KeySnapshot<Key>> keys;
+    keys.reserve(t1.size() + t2.size());
+    // Ghost lists hold no values and are not part of the hot set
+    for (const EntryList* list : {&t1, &t2}) {
+        for (const auto& entry : *list) {
+            keys.push_back({entry.key, entry.accessCount, pinnedKeys.find(entry.key) != pinnedKeys.end()});
+        }
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::adopt(CacheEntry<Key, Value> entry) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (entry.weight > maxBytes) {
+        return;
+    }
+    auto it = lookup.find(entry.key);
+    if (it != lookup.end()) {
+        if (it->second.segment == Segment::T1 || it->second.segment == Segment::T2) {
+            return;
+        }
+        erase(it);
+    }
+    if (!replace(entry.weight, false)) {
+        return;
+    }
+    
+    // Entries that were hit at least once count as frequent
+    Segment segment = entry.accessCount > 0 ? Segment::T2 : Segment::T1;
+    if (entry.isPinned) {
+        pinnedKeys.insert(entry.key);
+    }
+    segmentBytes(segment) += entry.weight;
+    EntryList& list = residentList(segment);
+    list.push_front(std::move(entry));
+    lookup[list.front().key] = Location{segment, list.begin(), {}};
+    trimGhosts();
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::store(const Key& key, const Value& value, bool promote) {
+    size_t weight = ValueWeigher<Value>::weigh(value);
+    auto it = lookup.find(key);
+    
+    if (weight > maxBytes) {
+        // Can never fit; drop any stale copy rather than keep serving it
+        if (it != lookup.end()) {
+            erase(it);
+            pinnedKeys.erase(key);
+        }
+        return false;
+    }
+    
+    if (it != lookup.end() &&
+        (it->second.segment == Segment::T1 || it->second.segment == Segment::T2)) {
+        // Update existing entry
+        auto entry = it->second.entry;
+        size_t& bytes = segmentBytes(it->second.segment);
+        bytes = bytes - entry->weight + weight;
+        entry->value = value;
+        entry->weight = weight;
+        entry->lastAccessed = std::chrono::system_clock::now();
+        if (promote && it->second.segment == Segment::T1) {
+            t1Bytes -= weight;
+            t2Bytes += weight;
+            t2.splice(t2.begin(), t1, entry);
+            it->second.segment = Segment::T2;
+        } else if (promote) {
+            t2.splice(t2.begin(), t2, entry);
+        }
+        replace(0, false);
+        return true;
+    }
+    
+    if (it != lookup.end()) {
+        // Ghost hit: adapt p towards the list that lost this key too early
+        bool ghostHitInB2 = it->second.segment == Segment::B2;
+        if (ghostHitInB2) {
+            size_t delta = weight * std::max<size_t>(1, b1Bytes / b2Bytes);
+            targetT1Bytes = targetT1Bytes > delta ? targetT1Bytes - delta : 0;
+        } else {
+            size_t delta = weight * std::max<size_t>(1, b2Bytes / b1Bytes);
+            targetT1Bytes = std::min(maxBytes, targetT1Bytes + delta);
+        }
+        erase(it);
+        
+        if (!replace(weight, ghostHitInB2)) {
+            return false;
+        }
+        t2.emplace_front(key, value);
+        lookup[key] = Location{Segment::T2, t2.begin(), {}};
+        t2Bytes += weight;
+        trimGhosts();
+        return true;
+    }
+    
+    // Brand new key enters T1
+    if (!replace(weight, false)) {
+        return false;
+    }
+    t1.emplace_front(key, value);
+    lookup[key] = Location{Segment::T1, t1.begin(), {}};
+    t1Bytes += weight;
+    trimGhosts();
+    return true;
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::replace(size_t incomingBytes, bool ghostHitInB2) {
+    while (t1Bytes + t2Bytes + incomingBytes > maxBytes) {
+        bool preferT1 = t1Bytes > 0 &&
+                        (t1Bytes > targetT1Bytes || (ghostHitInB2 && t1Bytes >= targetT1Bytes));
+        Segment first = preferT1 ? Segment::T1 : Segment::T2;
+        Segment second = preferT1 ? Segment::T2 : Segment::T1;
+        if (!evictFrom(first) && !evictFrom(second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::evictFrom(Segment segment) {
+    EntryList& list = residentList(segment);
+    Segment ghostSegment = segment == Segment::T1 ? Segment::B1 : Segment::B2;
+    GhostList& ghosts = ghostList(ghostSegment);
+    
+    // Pinned items found at the LRU end are rotated to MRU, at most once each
+    for (size_t scanned = 0; scanned < list.size(); ++scanned) {
+        auto victim = std::prev(list.end());
+        if (pinnedKeys.find(victim->key) != pinnedKeys.end()) {
+            list.splice(list.begin(), list, victim);
+            continue;
+        }
+        
+        size_t weight = victim->weight;
+        ghosts.emplace_front(victim->key, weight);
+        segmentBytes(ghostSegment) += weight;
+        segmentBytes(segment) -= weight;
+        
+        auto& location = lookup[victim->key];
+        location.segment = ghostSegment;
+        location.ghost = ghosts.begin();
+        
+        stats.bytesEvicted += weight;
+        stats.evictions++;
+        this->notifyEviction(victim->key, victim->value);
+        list.erase(victim);
+        return true;
+    }
+    return false;
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::trimGhosts() {
+    // Classic ARC bounds: |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c
+    while (!b1.empty() && t1Bytes + b1Bytes > maxBytes) {
+        dropGhost(Segment::B1);
+    }
+    while (!b2.empty() && t1Bytes + t2Bytes + b1Bytes + b2Bytes > 2 * maxBytes) {
+        dropGhost(Segment::B2);
+    }
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::dropGhost(Segment segment) {
+    GhostList& ghosts = ghostList(segment);
+    const auto& oldest = ghosts.back();
+    segmentBytes(segment) -= oldest.second;
+    lookup.erase(oldest.first);
+    ghosts.pop_back();
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::erase(typename std::unordered_map<Key, Location>::iterator it) {
+    Segment segment = it->second.segment;
+    if (segment == Segment::T1 || segment == Segment::T2) {
+        segmentBytes(segment) -= it->second.entry->weight;
+        residentList(segment).erase(it->second.entry);
+    } else {
+        segmentBytes(segment) -= it->second.ghost->second;
+        ghostList(segment).erase(it->second.ghost);
+    }
+    lookup.erase(it);
+}
+
+template<typename Key, typename Value>
+typename ARCCache<Key, Value>::EntryList& ARCCache<Key, Value>::residentList(Segment segment) {
+    return segment == Segment::T1 ? t1 : t2;
+}
+
+template<typename Key, typename Value>
+typename ARCCache<Key, Value>::GhostList& ARCCache<Key, Value>::ghostList(Segment segment) {
+    return segment == Segment::B1 ? b1 : b2;
+}
+
+template<typename Key, typename Value>
+size_t& ARCCache<Key, Value>::segmentBytes(Segment segment) {
+    switch (segment) {
+        case Segment::T1: return t1Bytes;
+        case Segment::T2: return t2Bytes;
+        case Segment::B1: return b1Bytes;
+        default: return b2Bytes;
+    }
+}
+
+// ===== ClockCache Implementation =====
+
+template<typename Key, typename Value>
+ClockCache<Key, Value>::ClockCache(size_t capacityBytes)
+    : maxBytes(capacityBytes), table(new Table(INITIAL_BUCKETS)) {}
+
+template<typename Key, typename Value>
+ClockCache<Key, Value>::~ClockCache() {
+    // No reader may outlive the cache, so everything can go at once
+    for (Node* node : ring) {
+        delete node;
+    }
+    for (Node* node : retiredNodes) {
+        delete node;
+    }
+    delete table.load();
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::put(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    store(key, value, 0, false);
+}
+
+template<typename Key, typename Value>
+std::optional<Value> ClockCache<Key, Value>::tryGet(const Key& key) {
+    size_t hash = hasher(key);
+    auto& counters = readerCounters[EpochDomain::slotIndex()];
+    EpochDomain::Guard guard(epoch);
+    
+    Node* node = find(key, hash);
+    if (!node) {
+        counters.misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    // Test before setting so a hot node's cache line stays shared
+    if (!node->referenced.load(std::memory_order_relaxed)) {
+        node->referenced.store(true, std::memory_order_relaxed);
+        node->accessCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    counters.hits.fetch_add(1, std::memory_order_relaxed);
+    return node->value;
+}
+
+template<typename Key, typename Value>
+bool ClockCache<Key, Value>::contains(const Key& key) const {
+    size_t hash = hasher(key);
+    EpochDomain::Guard guard(epoch);
+    return find(key, hash) != nullptr;
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (Node* node = find(key, hasher(key))) {
+        removeNode(node);
+    }
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    clearLocked();
+}
+
+template<typename Key, typename Value>
+size_t ClockCache<Key, Value>::size() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return ring.size();
+}
+
+template<typename Key, typename Value>
+size_t ClockCache<Key, Value>::capacity() const {
+    return maxBytes;
+}
+
+template<typename Key, typename Value>
+CacheStatistics ClockCache<Key, Value>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto statsCopy = stats;
+    for (const auto& counters : readerCounters) {
+        statsCopy.hits += counters.hits.load(std::memory_order_relaxed);
+        statsCopy.misses += counters.misses.load(std::memory_order_relaxed);
+    }
+    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.residentBytes = currentBytes;
+    statsCopy.updateHitRate();
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::resetStatistics() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    stats = CacheStatistics();
+    for (auto& counters : readerCounters) {
+        counters.hits.store(0, std::memory_order_relaxed);
+        counters.misses.store(0, std::memory_order_relaxed);
+    }
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::pin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (find(key, hasher(key))) {
+        pinnedKeys.insert(key);
+    }
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::unpin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    pinnedKeys.erase(key);
+}
+
+template<typename Key, typename Value>
+bool ClockCache<Key, Value>::isPinned(const Key& key) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return pinnedKeys.find(key) != pinnedKeys.end();
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::prefetch(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (store(key, value, 0, false)) {
+        stats.prefetchedItems++;
+    }
+}
+
+template<typename Key, typename Value>
+std::vector<Key> ClockCache<Key, Value>::getKeys() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<Key> keys;
+    keys.reserve(ring.size());
+    for (const Node* node : ring) {
+        keys.push_back(node->key);
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+std::optional<Key> ClockCache<Key, Value>::evictionCandidate(size_t incomingBytes) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (currentBytes + incomingBytes <= maxBytes) {
+        return std::nullopt;
+    }
+    // Where the hand would stop, without clearing any reference bits: the
+    // first unreferenced node, or the first unpinned one after a full sweep
+    std::optional<Key> afterSweep;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        const Node* node = ring[(hand + i) % ring.size()];
+        if (pinnedKeys.find(node->key) != pinnedKeys.end()) {
+            continue;
+        }
+        if (!node->referenced.load(std::memory_order_relaxed)) {
+            return node->key;
+        }
+        if (!afterSweep) {
+            afterSweep = node->key;
+        }
+    }
+    return afterSweep;
+}
+
+template<typename Key, typename Value>
+std::vector<CacheEntry<Key, Value>> ClockCache<Key, Value>::drain() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<CacheEntry<Key, Value>> drained;
+    drained.reserve(ring.size());
+    // Unreferenced nodes first, then referenced ones, each in hand order
+    for (bool referenced : {false, true}) {
+        for (size_t i = 0; i < ring.size(); ++i) {
+            const Node* node = ring[(hand + i) % ring.size()];
+            if (node->referenced.load(std::memory_order_relaxed) != referenced) {
+                continue;
+            }
+            CacheEntry<Key, Value> entry(node->key, node->value);
+            entry.accessCount = node->accessCount.load(std::memory_order_relaxed);
+            entry.isPinned = pinnedKeys.find(node->key) != pinnedKeys.end();
+            drained.push_back(std::move(entry));
+        }
+    }
+    clearLocked();
+    return drained;
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::adopt(CacheEntry<Key, Value> entry) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (entry.weight > maxBytes || find(entry.key, hasher(entry.key)) ||
+        !store(entry.key, entry.value, entry.accessCount, entry.accessCount > 0)) {
+        return;
+    }
+    if (entry.isPinned) {
+        pinnedKeys.insert(entry.key);
+    }
+}
+
+template<typename Key, typename Value>
+std::vector<KeySnapshot<Key>> ClockCache<Key, Value>::snapshot() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<KeySnapshot<Key>> keys;
+    keys.reserve(ring.size());
+    for (const Node* node : ring) {
+        keys.push_back({node->key, node->accessCount.load(std::memory_order_relaxed),
+                        pinnedKeys.find(node->key) != pinnedKeys.end()});
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+typename ClockCache<Key, Value>::Node* ClockCache<Key, Value>::find(const Key& key, size_t hash) const {
+    // Callers hold an epoch guard or cacheMutex
+    Table* current = table.load();
+    for (Node* node = current->buckets[hash & current->mask].load(); node; node = node->next.load()) {
+        if (node->hash == hash && node->key == key) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+template<typename Key, typename Value>
+bool ClockCache<Key, Value>::store(const Key& key, const Value& value, size_t accessCount, bool referenced) {
+    size_t hash = hasher(key);
+    Node* existing = find(key, hash);
+    
+    if (ValueWeigher<Value>::weigh(value) > maxBytes) {
+        // Can never fit; drop any stale copy rather than keep serving it
+        if (existing) {
+            removeNode(existing);
+        }
+        return false;
+    }
+    
+    if (existing) {
+        // Publish the replacement in front of the old node before unlinking
+        // it, so readers see one or the other but never a miss
+        Node* node = new Node(key, hash, value);
+        node->referenced.store(true, std::memory_order_relaxed);
+        node->accessCount.store(existing->accessCount.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+        link(node);
+        unlink(existing);
+        node->ringIndex = existing->ringIndex;
+        ring[node->ringIndex] = node;
+        currentBytes = currentBytes - existing->weight + node->weight;
+        retire(existing);
+        makeRoom(0);
+        return true;
+    }
+    
+    if (!makeRoom(ValueWeigher<Value>::weigh(value))) {
+        return false;
+    }
+    Node* node = new Node(key, hash, value);
+    node->referenced.store(referenced, std::memory_order_relaxed);
+    node->accessCount.store(accessCount, std::memory_order_relaxed);
+    node->ringIndex = ring.size();
+    ring.push_back(node);
+    link(node);
+    currentBytes += node->weight;
+    if (ring.size() > table.load()->mask + 1) {
+        grow();
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::link(Node* node) {
+    Table* current = table.load();
+    auto& bucket = current->buckets[node->hash & current->mask];
+    node->next.store(bucket.load());
+    bucket.store(node);
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::unlink(Node* node) {
+    // Readers standing on the node keep following its next pointer, which
+    // stays valid until the node is reclaimed
+    Table* current = table.load();
+    std::atomic<Node*>* link = &current->buckets[node->hash & current->mask];
+    while (link->load() != node) {
+        link = &link->load()->next;
+    }
+    link->store(node->next.load());
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::removeNode(Node* node) {
+    unlink(node);
+    Node* last = ring.back();
+    ring[node->ringIndex] = last;
+    last->ringIndex = node->ringIndex;
+    ring.pop_back();
+    if (hand >= ring.size()) {
+        hand = 0;
+    }
+    currentBytes -= node->weight;
+    pinnedKeys.erase(node->key);
+    retire(node);
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::retire(Node* node) {
+    retiredNodes.push_back(node);
+    if (retiredNodes.size() >= RETIRE_BATCH) {
+        reclaim();
+    }
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::reclaim() {
+    epoch.synchronize();
+    for (Node* node : retiredNodes) {
+        delete node;
+    }
+    retiredNodes.clear();
+    retiredTables.clear();
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::grow() {
+    // Readers may be walking the old chains, so the new table gets copies
+    // of the nodes and the originals are retired with the old table
+    Table* old = table.load();
+    auto grown = std::make_unique<Table>((old->mask + 1) * 2);
+    for (Node*& slot : ring) {
+        Node* copy = new Node(slot->key, slot->hash, slot->value);
+        copy->referenced.store(slot->referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        copy->accessCount.store(slot->accessCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        copy->ringIndex = slot->ringIndex;
+        auto& bucket = grown->buckets[copy->hash & grown->mask];
+        copy->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        bucket.store(copy, std::memory_order_relaxed);
+        retiredNodes.push_back(slot);
+        slot = copy;
+    }
+    table.store(grown.release());
+    retiredTables.emplace_back(old);
+    reclaim();
+}
+
+template<typename Key, typename Value>
+bool ClockCache<Key, Value>::makeRoom(size_t incomingBytes) {
+    while (currentBytes + incomingBytes > maxBytes) {
+        if (!evict()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+bool ClockCache<Key, Value>::evict() {
+    // Two revolutions clear every reference bit once; only pinned nodes
+    // can survive both
+    for (size_t scanned = 0; scanned < 2 * ring.size(); ++scanned) {
+        if (hand >= ring.size()) {
+            hand = 0;
+        }
+        Node* node = ring[hand];
+        if (pinnedKeys.find(node->key) != pinnedKeys.end()) {
+            hand++;
+            continue;
+        }
+        if (node->referenced.load(std::memory_order_relaxed)) {
+            node->referenced.store(false, std::memory_order_relaxed);
+            hand++;
+            continue;
+        }
+        stats.evictions++;
+        stats.bytesEvicted += node->weight;
+        this->notifyEviction(node->key, node->value);
+        // The last node moves into this slot and is looked at next
+        removeNode(node);
+        return true;
+    }
+    return false;
+}
+
+template<typename Key, typename Value>
+void ClockCache<Key, Value>::clearLocked() {
+    retiredTables.emplace_back(table.exchange(new Table(INITIAL_BUCKETS)));
+    retiredNodes.insert(retiredNodes.end(), ring.begin(), ring.end());
+    ring.clear();
+    hand = 0;
+    currentBytes = 0;
+    pinnedKeys.clear();
+    reclaim();
+}
+
+// ===== ClockProCache Implementation =====
+
+template<typename Key, typename Value>
+ClockProCache<Key, Value>::ClockProCache(size_t capacityBytes)
+    : maxBytes(capacityBytes),
+      minColdBytes(std::min(capacityBytes, std::max<size_t>(1, capacityBytes / MIN_COLD_SHARE))),
+      coldTargetBytes(capacityBytes),
+      buckets(INITIAL_BUCKETS, NIL),
+      indexShift(std::numeric_limits<size_t>::digits - 6) {}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::put(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    store(key, value, 0, false);
+}
+
+template<typename Key, typename Value>
+std::optional<Value> ClockProCache<Key, Value>::tryGet(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    uint32_t index = find(key, hashOf(key));
+    if (!isResident(index)) {
+        stats.misses++;
+        return std::nullopt;
+    }
+    // The whole hit: no reordering, allocation or timestamp
+    Slot& slot = slots[index];
+    slot.referenced = true;
+    slot.accessCount++;
+    stats.hits++;
+    return slot.value;
+}
+
+template<typename Key, typename Value>
+bool ClockProCache<Key, Value>::contains(const Key& key) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return isResident(find(key, hashOf(key)));
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    uint32_t index = find(key, hashOf(key));
+    if (index != NIL) {
+        erase(index);
+    }
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    clearLocked();
+}
+
+template<typename Key, typename Value>
+size_t ClockProCache<Key, Value>::size() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return residentCount;
+}
+
+template<typename Key, typename Value>
+size_t ClockProCache<Key, Value>::capacity() const {
+    return maxBytes;
+}
+
+template<typename Key, typename Value>
+CacheStatistics ClockProCache<Key, Value>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto statsCopy = stats;
+    statsCopy.pinnedItems = pinnedCount;
+    statsCopy.residentBytes = hotBytes + coldBytes;
+    statsCopy.updateHitRate();
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::resetStatistics() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    stats = CacheStatistics();
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::pin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    uint32_t index = find(key, hashOf(key));
+    if (isResident(index) && !slots[index].pinned) {
+        slots[index].pinned = true;
+        pinnedCount++;
+    }
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::unpin(const Key& key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    uint32_t index = find(key, hashOf(key));
+    if (index != NIL && slots[index].pinned) {
+        slots[index].pinned = false;
+        pinnedCount--;
+    }
+}
+
+template<typename Key, typename Value>
+bool ClockProCache<Key, Value>::isPinned(const Key& key) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    uint32_t index = find(key, hashOf(key));
+    return index != NIL && slots[index].pinned;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::prefetch(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (store(key, value, 0, false)) {
+        stats.prefetchedItems++;
+    }
+}
+
+template<typename Key, typename Value>
+std::vector<Key> ClockProCache<Key, Value>::getKeys() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<Key> keys;
+    keys.reserve(residentCount);
+    for (const Slot& slot : slots) {
+        if (slot.state == SlotState::Hot || slot.state == SlotState::Cold) {
+            keys.push_back(slot.key);
+        }
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+std::optional<Key> ClockProCache<Key, Value>::evictionCandidate(size_t incomingBytes) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (hotBytes + coldBytes + incomingBytes <= maxBytes) {
+        return std::nullopt;
+    }
+    // Where the cold hand would stop: the first unreferenced cold entry.
+    // Failing that, the first entry a later sweep could demote and evict.
+    std::optional<Key> afterSweep;
+    uint32_t index = handCold;
+    for (size_t i = 0; i < ringSize; ++i, index = slots[index].next) {
+        const Slot& slot = slots[index];
+        if (slot.state == SlotState::Test || slot.pinned) {
+            continue;
+        }
+        if (slot.state == SlotState::Cold && !slot.referenced) {
+            return slot.key;
+        }
+        if (!afterSweep) {
+            afterSweep = slot.key;
+        }
+    }
+    return afterSweep;
+}
+
+template<typename Key, typename Value>
+std::vector<CacheEntry<Key, Value>> ClockProCache<Key, Value>::drain() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<CacheEntry<Key, Value>> drained;
+    drained.reserve(residentCount);
+    // Cold entries in cold hand order, then hot ones in hot hand order, so
+    // the hot set is adopted last and evicted last
+    for (auto [state, start] : {std::make_pair(SlotState::Cold, handCold),
+                                std::make_pair(SlotState::Hot, handHot)}) {
+        uint32_t index = start;
+        for (size_t i = 0; i < ringSize; ++i, index = slots[index].next) {
+            const Slot& slot = slots[index];
+            if (slot.state != state) {
+                continue;
+            }
+            CacheEntry<Key, Value> entry(slot.key, *slot.value);
+            entry.accessCount = slot.accessCount;
+            entry.isPinned = slot.pinned;
+            drained.push_back(std::move(entry));
+        }
+    }
+    clearLocked();
+    return drained;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::adopt(CacheEntry<Key, Value> entry) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (entry.weight > maxBytes || isResident(find(entry.key, hashOf(entry.key))) ||
+        !store(entry.key, entry.value, entry.accessCount, entry.accessCount > 0)) {
+        return;
+    }
+    if (entry.isPinned) {
+        Slot& slot = slots[find(entry.key, hashOf(entry.key))];
+        if (!slot.pinned) {
+            slot.pinned = true;
+            pinnedCount++;
+        }
+    }
+}
+
+template<typename Key, typename Value>
+std::vector<KeySnapshot<Key>> ClockProCache<Key, Value>::snapshot() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::vector<KeySnapshot<Key>> keys;
+    keys.reserve(residentCount);
+    for (const Slot& slot : slots) {
+        if (slot.state == SlotState::Hot || slot.state == SlotState::Cold) {
+            keys.push_back({slot.key, slot.accessCount, slot.pinned});
+        }
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+size_t ClockProCache<Key, Value>::hashOf(const Key& key) const {
+    // Fibonacci hashing; the index uses the top bits, which weak std::hash
+    // results (e.g. identity for ints) leave badly distributed
+    return hasher(key) * static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+}
+
+template<typename Key, typename Value>
+size_t ClockProCache<Key, Value>::home(size_t hash) const {
+    return hash >> indexShift;
+}
+
+template<typename Key, typename Value>
+uint32_t ClockProCache<Key, Value>::find(const Key& key, size_t hash) const {
+    const size_t mask = buckets.size() - 1;
+    for (size_t bucket = home(hash);; bucket = (bucket + 1) & mask) {
+        uint32_t index = buckets[bucket];
+        if (index == NIL) {
+            return NIL;
+        }
+        if (slots[index].hash == hash && slots[index].key == key) {
+            return index;
+        }
+    }
+}
+
+template<typename Key, typename Value>
+bool ClockProCache<Key, Value>::isResident(uint32_t index) const {
+    return index != NIL && slots[index].state != SlotState::Test;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::indexInsert(uint32_t index) {
+    const size_t mask = buckets.size() - 1;
+    size_t bucket = home(slots[index].hash);
+    while (buckets[bucket] != NIL) {
+        bucket = (bucket + 1) & mask;
+    }
+    buckets[bucket] = index;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::indexErase(uint32_t index) {
+    const size_t mask = buckets.size() - 1;
+    size_t hole = home(slots[index].hash);
+    while (buckets[hole] != index) {
+        hole = (hole + 1) & mask;
+    }
+    // Backward-shift deletion: pull later entries of the probe run into the
+    // hole when it lies between their home bucket and where they sit, so
+    // lookups never need tombstones
+    for (size_t bucket = (hole + 1) & mask; buckets[bucket] != NIL; bucket = (bucket + 1) & mask) {
+        size_t wanted = home(slots[buckets[bucket]].hash);
+        if (((bucket - wanted) & mask) >= ((bucket - hole) & mask)) {
+            buckets[hole] = buckets[bucket];
+            hole = bucket;
+        }
+    }
+    buckets[hole] = NIL;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::growIndex() {
+    buckets.assign(buckets.size() * 2, NIL);
+    indexShift--;
+    for (uint32_t index = 0; index < slots.size(); ++index) {
+        if (slots[index].state != SlotState::Free) {
+            indexInsert(index);
+        }
+    }
+}
+
+template<typename Key, typename Value>
+bool ClockProCache<Key, Value>::store(const Key& key, const Value& value, size_t accessCount, bool referenced) {
+    size_t hash = hashOf(key);
+    uint32_t index = find(key, hash);
+    size_t weight = ValueWeigher<Value>::weigh(value);
+    
+    if (weight > maxBytes) {
+        // Can never fit; drop any stale copy rather than keep serving it
+        if (index != NIL) {
+            erase(index);
+        }
+        return false;
+    }
+    
+    if (isResident(index)) {
+        Slot& slot = slots[index];
+        size_t& segmentBytes = slot.state == SlotState::Hot ? hotBytes : coldBytes;
+        segmentBytes = segmentBytes - slot.weight + weight;
+        slot.value = value;
+        slot.weight = weight;
+        slot.referenced = true;
+        makeRoom(0);
+        return true;
+    }
+    
+    // A miss on a test entry: it was reused within the test period, so it
+    // comes back hot and cold entries get more room to prove themselves
+    bool reused = index != NIL;
+    if (reused) {
+        coldTargetBytes = std::min(maxBytes, coldTargetBytes + slots[index].weight);
+        accessCount = std::max(accessCount, slots[index].accessCount);
+        erase(index);
+    }
+    
+    if (!makeRoom(weight)) {
+        return false;
+    }
+    index = allocate(key, hash);
+    Slot& slot = slots[index];
+    slot.value = value;
+    slot.weight = weight;
+    slot.accessCount = accessCount;
+    slot.state = reused ? SlotState::Hot : SlotState::Cold;
+    slot.referenced = !reused && referenced;
+    (reused ? hotBytes : coldBytes) += weight;
+    residentCount++;
+    return true;
+}
+
+template<typename Key, typename Value>
+uint32_t ClockProCache<Key, Value>::allocate(const Key& key, size_t hash) {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+    slots[index].key = key;
+    slots[index].hash = hash;
+    // Keep the index at most half full so probe runs stay short
+    if ((ringSize + 1) * 2 > buckets.size()) {
+        growIndex();
+    }
+    indexInsert(index);
+    link(index);
+    ringSize++;
+    return index;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::link(uint32_t index) {
+    Slot& slot = slots[index];
+    if (handHot == NIL) {
+        slot.prev = slot.next = index;
+        handHot = handCold = handTest = index;
+        return;
+    }
+    // New entries go just behind the hot hand, the head of the clock
+    uint32_t before = slots[handHot].prev;
+    slot.prev = before;
+    slot.next = handHot;
+    slots[before].next = index;
+    slots[handHot].prev = index;
+    if (handCold == handHot) {
+        handCold = index;
+    }
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::erase(uint32_t index) {
+    Slot& slot = slots[index];
+    switch (slot.state) {
+        case SlotState::Hot: hotBytes -= slot.weight; residentCount--; break;
+        case SlotState::Cold: coldBytes -= slot.weight; residentCount--; break;
+        case SlotState::Test: testBytes -= slot.weight; break;
+        case SlotState::Free: return;
+    }
+    if (slot.pinned) {
+        pinnedCount--;
+    }
+    indexErase(index);
+    
+    // Hands standing on the slot step back, so their next move lands on
+    // the entry that followed it
+    if (slot.next == index) {
+        handHot = handCold = handTest = NIL;
+    } else {
+        for (uint32_t* hand : {&handHot, &handCold, &handTest}) {
+            if (*hand == index) {
+                *hand = slot.prev;
+            }
+        }
+        slots[slot.prev].next = slot.next;
+        slots[slot.next].prev = slot.prev;
+    }
+    
+    slot = Slot();
+    freeSlots.push_back(index);
+    ringSize--;
+}
+
+template<typename Key, typename Value>
+bool ClockProCache<Key, Value>::makeRoom(size_t incomingBytes) {
+    // Bounded so that a ring of pinned entries fails instead of spinning;
+    // four laps are enough to clear, demote and evict any unpinned entry
+    size_t idleSteps = 0;
+    for (size_t steps = 0; hotBytes + coldBytes + incomingBytes > maxBytes; ++steps) {
+        if (ringSize == 0 || steps > 4 * ringSize) {
+            return false;
+        }
+        // Nothing cold left to take, or a lap without progress: demote
+        if (coldBytes == 0 || idleSteps > ringSize) {
+            runHandHot();
+        }
+        idleSteps = runHandCold() ? 0 : idleSteps + 1;
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+bool ClockProCache<Key, Value>::runHandCold() {
+    if (handCold == NIL) {
+        return false;
+    }
+    bool evicted = false;
+    Slot& slot = slots[handCold];
+    if (slot.state == SlotState::Cold && !slot.pinned) {
+        if (slot.referenced) {
+            // Reused while cold: its reuse distance is short enough for hot
+            slot.state = SlotState::Hot;
+            slot.referenced = false;
+            coldBytes -= slot.weight;
+            hotBytes += slot.weight;
+        } else {
+            // Evicted, but remembered for a test period
+            slot.state = SlotState::Test;
+            this->notifyEviction(slot.key, *slot.value);
+            slot.value.reset();
+            coldBytes -= slot.weight;
+            testBytes += slot.weight;
+            residentCount--;
+            stats.evictions++;
+            stats.bytesEvicted += slot.weight;
+            evicted = true;
+            while (testBytes > maxBytes) {
+                runHandTest();
+            }
+        }
+    }
+    if (handCold != NIL) {
+        handCold = slots[handCold].next;
+    }
+    
+    for (size_t steps = 0; hotBytes > maxBytes - coldTargetBytes && steps <= 2 * ringSize; ++steps) {
+        runHandHot();
+    }
+    return evicted;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::runHandHot() {
+    // The hot hand pushes the test hand ahead of it
+    if (handHot == handTest) {
+        runHandTest();
+    }
+    if (handHot == NIL) {
+        return;
+    }
+    Slot& slot = slots[handHot];
+    if (slot.state == SlotState::Hot && !slot.pinned) {
+        if (slot.referenced) {
+            slot.referenced = false;
+        } else {
+            slot.state = SlotState::Cold;
+            hotBytes -= slot.weight;
+            coldBytes += slot.weight;
+        }
+    }
+    handHot = slots[handHot].next;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::runHandTest() {
+    if (handTest == NIL) {
+        return;
+    }
+    uint32_t index = handTest;
+    if (slots[index].state == SlotState::Test) {
+        // The test period ran out without a reuse: cold entries get less room
+        size_t weight = slots[index].weight;
+        coldTargetBytes = std::max(minColdBytes, coldTargetBytes - std::min(coldTargetBytes, weight));
+        erase(index);
+        if (handTest == NIL) {
+            return;
+        }
+    }
+    handTest = slots[handTest].next;
+}
+
+template<typename Key, typename Value>
+void ClockProCache<Key, Value>::clearLocked() {
+    slots.clear();
+    freeSlots.clear();
+    buckets.assign(INITIAL_BUCKETS, NIL);
+    indexShift = std::numeric_limits<size_t>::digits - 6;
+    handHot = handCold = handTest = NIL;
+    coldTargetBytes = maxBytes;
+    hotBytes = coldBytes = testBytes = 0;
+    residentCount = ringSize = pinnedCount = 0;
+}
+
+// ===== PolicyTuner Implementation =====
+
+template<typename Key, typename Value>
+std::unique_ptr<CacheInterface<Key, Value>> makePolicyCache(CachePolicy policy, size_t capacityBytes) {
+    switch (policy) {
+        case CachePolicy::LRU:
+            return std::make_unique<EnhancedLRUCache<Key, Value>>(capacityBytes);
+        case CachePolicy::LFU:
+            return std::make_unique<LFUCache<Key, Value>>(capacityBytes);
+        case CachePolicy::FIFO:
+            return std::make_unique<FIFOCache<Key, Value>>(capacityBytes);
+        case CachePolicy::LIFO:
+            return std::make_unique<LIFOCache<Key, Value>>(capacityBytes);
+        case CachePolicy::ARC:
+            return std::make_unique<ARCCache<Key, Value>>(capacityBytes);
+        case CachePolicy::CLOCK:
+            return std::make_unique<ClockCache<Key, Value>>(capacityBytes);
+        case CachePolicy::CLOCK_PRO:
+            return std::make_unique<ClockProCache<Key, Value>>(capacityBytes);
+        default:
+            return std::make_unique<EnhancedLRUCache<Key, Value>>(capacityBytes);
+    }
+}
+
+template<typename Key, typename Value>
+PolicyTuner<Key, Value>::PolicyTuner(CachePolicy policy, size_t capacity)
+    : livePolicy(policy), capacityBytes(capacity) {
+    rebuildShadows();
+}
+
+template<typename Key, typename Value>
+bool PolicyTuner<Key, Value>::recordLookup(const Key& key, const std::optional<Value>& value) {
+    if (!sampled(key)) {
+        return false;
+    }
+    // Every shadow sees the same stream, so a sample lost to contention
+    // does not favour any policy
+    std::unique_lock<std::mutex> lock(tunerMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    for (auto& shadow : shadows) {
+        if (shadow.cache->tryGet(key)) {
+            shadow.hits++;
+            continue;
+        }
+        shadow.misses++;
+        // A real miss is followed by the caller's put(); a real hit is not,
+        // so the shadow loads the entry itself
+        if (value) {
+            shadow.cache->put(key, ShadowEntry{ValueWeigher<Value>::weigh(*value)});
+        }
+    }
+    if (++windowLookups >= WINDOW_SAMPLES && !evaluationDue) {
+        evaluationDue = true;
+        return true;
+    }
+    return false;
+}
+
+template<typename Key, typename Value>
+void PolicyTuner<Key, Value>::recordInsert(const Key& key, const Value& value) {
+    if (!sampled(key)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(tunerMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    ShadowEntry entry{ValueWeigher<Value>::weigh(value)};
+    for (auto& shadow : shadows) {
+        shadow.cache->put(key, entry);
+    }
+}
+
+template<typename Key, typename Value>
+void PolicyTuner<Key, Value>::reconfigure(CachePolicy policy, size_t capacity) {
+    std::lock_guard<std::mutex> lock(tunerMutex);
+    if (policy == livePolicy && capacity == capacityBytes) {
+        return;
+    }
+    bool resized = capacity != capacityBytes;
+    livePolicy = policy;
+    capacityBytes = capacity;
+    bool haveLive = std::any_of(shadows.begin(), shadows.end(),
+                                [policy](const Shadow& shadow) { return shadow.policy == policy; });
+    if (resized || !haveLive) {
+        // A cold shadow would lose every comparison, start over
+        rebuildShadows();
+    } else {
+        // Drop the shadow of a previous live policy that is no candidate
+        shadows.erase(std::remove_if(shadows.begin(), shadows.end(),
+                                     [policy](const Shadow& shadow) {
+                                         return shadow.policy != policy && shadow.policy != CachePolicy::LRU &&
+                                                shadow.policy != CachePolicy::LFU &&
+                                                shadow.policy != CachePolicy::FIFO &&
+                                                shadow.policy != CachePolicy::ARC;
+                                     }),
+                      shadows.end());
+    }
+}
+
+template<typename Key, typename Value>
+std::optional<CachePolicy> PolicyTuner<Key, Value>::evaluate() {
+    std::lock_guard<std::mutex> lock(tunerMutex);
+    evaluationDue = false;
+    if (windowLookups < WINDOW_SAMPLES) {
+        return std::nullopt;
+    }
+    evaluations++;
+    
+    lastEstimates.clear();
+    double liveRate = 0.0;
+    std::optional<PolicyEstimate> best;
+    for (const auto& shadow : shadows) {
+        size_t total = shadow.hits + shadow.misses;
+        PolicyEstimate estimate{shadow.policy, total > 0 ? (static_cast<double>(shadow.hits) / total) * 100.0 : 0.0};
+        lastEstimates.push_back(estimate);
+        if (shadow.policy == livePolicy) {
+            liveRate = estimate.hitRate;
+        } else if (!best || estimate.hitRate > best->hitRate) {
+            best = estimate;
+        }
+    }
+    resetWindow();
+    
+    if (cooldown > 0) {
+        cooldown--;
+        return std::nullopt;
+    }
+    if (!best || best->hitRate < liveRate + SWITCH_MARGIN) {
+        leader.reset();
+        leaderWindows = 0;
+        return std::nullopt;
+    }
+    if (leader != best->policy) {
+        leader = best->policy;
+        leaderWindows = 0;
+    }
+    if (++leaderWindows < CONFIRM_WINDOWS) {
+        return std::nullopt;
+    }
+    leader.reset();
+    leaderWindows = 0;
+    cooldown = COOLDOWN_WINDOWS;
+    switches++;
+    return best->policy;
+}
+
+template<typename Key, typename Value>
+TuningStatistics PolicyTuner<Key, Value>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(tunerMutex);
+    TuningStatistics statsCopy;
+    statsCopy.enabled = true;
+    statsCopy.livePolicy = livePolicy;
+    statsCopy.sampleRate = sampleRate;
+    statsCopy.evaluations = evaluations;
+    statsCopy.switches = switches;
+    statsCopy.estimates = lastEstimates;
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+bool PolicyTuner<Key, Value>::sampled(const Key& key) const {
+    if (sampleRate == 1) {
+        return true;
+    }
+    // High bits, independent of the ones CacheManager picks shards with
+    size_t mixed = hasher(key) * static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+    return (mixed >> 40) % sampleRate == 0;
+}
+
+template<typename Key, typename Value>
+void PolicyTuner<Key, Value>::rebuildShadows() {
+    sampleRate = 1;
+    while (sampleRate < MAX_SAMPLE_RATE && capacityBytes / (sampleRate * 2) >= MIN_SHADOW_CAPACITY) {
+        sampleRate *= 2;
+    }
+    size_t shadowCapacity = std::max<size_t>(1, capacityBytes / sampleRate);
+    
+    shadows.clear();
+    std::vector<CachePolicy> policies = {CachePolicy::LRU, CachePolicy::LFU, CachePolicy::FIFO, CachePolicy::ARC};
+    if (std::find(policies.begin(), policies.end(), livePolicy) == policies.end()) {
+        policies.push_back(livePolicy);
+    }
+    for (CachePolicy policy : policies) {
+        shadows.push_back(Shadow{policy, makePolicyCache<Key, ShadowEntry>(policy, shadowCapacity)});
+    }
+    resetWindow();
+    leader.reset();
+    leaderWindows = 0;
+}
+
+template<typename Key, typename Value>
+void PolicyTuner<Key, Value>::resetWindow() {
+    for (auto& shadow : shadows) {
+        shadow.hits = 0;
+        shadow.misses = 0;
+    }
+    windowLookups = 0;
+}
+
+// ===== CacheManager Implementation =====
+
+template<typename Key, typename Value>
+CacheManager<Key, Value>::CacheManager(size_t capacityBytes, CachePolicy policy, size_t shardCount) 
+    : cacheCapacity(capacityBytes), currentPolicy(policy), requestedShards(shardCount) {
+    recreateCache();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::put(const Key& key, const Value& value) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    size_t index = shardIndex(key);
+    if (admissionPolicy != AdmissionPolicy::None && !admit(index, key, value)) {
+        // The new value is not cached, so an older copy in the tiers must
+        // not be promoted in its place
+        invalidateTiers(key);
+        return;
+    }
+    discardFromTiers(key);
+    shards[index]->put(key, value);
+    flushEvictions(compressedTier.get(), spillTier.get());
+    if (policyTuner) {
+        policyTuner->recordInsert(key, value);
+    }
+}
+
+template<typename Key, typename Value>
+std::optional<Value> CacheManager<Key, Value>::tryGet(const Key& key) {
+    bool tuningDue = false;
+    auto value = lookup(key, tuningDue);
+    if (tuningDue) {
+        // Outside the epoch guard and managerMutex, a switch rebuilds the shards
+        optimizeForWorkload();
+    }
+    return value;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> CacheManager<Key, Value>::lookup(const Key& key, bool& tuningDue) {
+    {
+        // Fast path: no shared lock, so hits on different shards share no
+        // cache line; with CLOCK shards the whole hit is lock-free
+        EpochDomain::Guard guard(readEpoch);
+        if (const ReadView* view = readView.load()) {
+            size_t index = shardIndex(key, view->shards.size());
+            if (!view->filters.empty()) {
+                recordAccess(*view->filters[index], key);
+            }
+            recordLookup(key);
+            auto value = view->shards[index]->tryGet(key);
+            if (!value && (view->compressed || view->spill)) {
+                value = promoteFromTiers(view->compressed, view->spill, *view->shards[index], key);
+            }
+            if (view->tuner) {
+                tuningDue = view->tuner->recordLookup(key, value);
+            }
+            return value;
+        }
+    }
+    
+    // A policy switch or resize is in progress
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    size_t index = shardIndex(key);
+    if (admissionPolicy != AdmissionPolicy::None) {
+        recordAccess(*admissionFilters[index], key);
+    }
+    recordLookup(key);
+    auto value = shards[index]->tryGet(key);
+    if (!value && (compressedTier || spillTier)) {
+        value = promoteFromTiers(compressedTier.get(), spillTier.get(), *shards[index], key);
     }
+    if (policyTuner) {
+        tuningDue = policyTuner->recordLookup(key, value);
+    }
+    return value;
+}
+
+template<typename Key, typename Value>
+Value CacheManager<Key, Value>::get(const Key& key) {
+    auto value = tryGet(key);
+    if (!value) {
+        throw std::runtime_error("Key not found in cache");
+    }
+    return std::move(*value);
+}
+
+template<typename Key, typename Value>
+bool CacheManager<Key, Value>::contains(const Key& key) const {
+    {
+        EpochDomain::Guard guard(readEpoch);
+        if (const ReadView* view = readView.load()) {
+            return view->shards[shardIndex(key, view->shards.size())]->contains(key);
+        }
+    }
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return shardFor(key).contains(key);
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::remove(const Key& key) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    // Before: a promotion of a lower-tier copy notices and undoes itself.
+    // After: catches the copy a concurrent eviction may have just moved down.
+    invalidateTiers(key);
+    shardFor(key).remove(key);
+    invalidateTiers(key);
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::removeIf(const std::function<bool(const Key&)>& predicate) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    // Same ordering as remove()
+    size_t removed = invalidateTiersIf(predicate);
+    for (auto& shard : shards) {
+        removed += shard->removeIf(predicate);
+    }
+    removed += invalidateTiersIf(predicate);
+    return removed;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::clear() {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    auto everything = [](const Key&) { return true; };
+    invalidateTiersIf(everything);
+    for (auto& shard : shards) {
+        shard->clear();
+    }
+    invalidateTiersIf(everything);
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::size() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard->size();
+    }
+    return total;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::setPolicy(CachePolicy policy) {
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    if (currentPolicy != policy) {
+        currentPolicy = policy;
+        recreateCache();
+    }
+}
+
+template<typename Key, typename Value>
+CachePolicy CacheManager<Key, Value>::getPolicy() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return currentPolicy;
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::capacity() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return cacheCapacity;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::resize(size_t newCapacityBytes) {
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    if (cacheCapacity != newCapacityBytes) {
+        cacheCapacity = newCapacityBytes;
+        recreateCache();
+    }
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::getShardCount() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return shards.size();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::setAdmissionPolicy(AdmissionPolicy policy) {
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    if (admissionPolicy != policy) {
+        retractReadView();
+        admissionPolicy = policy;
+        recreateAdmissionFilters();
+        publishReadView();
+    }
+}
+
+template<typename Key, typename Value>
+AdmissionPolicy CacheManager<Key, Value>::getAdmissionPolicy() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return admissionPolicy;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::enableSpillTier(const std::string& path, size_t capacityBytes) {
+    static_assert(SpillCodec<Value>::supported, "spilling needs a SpillCodec for the value type");
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    retractReadView();
+    // The old tier's contents are dropped with it
+    spillTier.reset();
+    spillTier = std::make_unique<SpillTier<Key, Value>>(path, capacityBytes);
+    installEvictionListeners();
+    publishReadView();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::disableSpillTier() {
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    if (!spillTier) {
+        return;
+    }
+    retractReadView();
+    spillTier.reset();
+    installEvictionListeners();
+    publishReadView();
+}
+
+template<typename Key, typename Value>
+bool CacheManager<Key, Value>::hasSpillTier() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return spillTier != nullptr;
+}
+
+template<typename Key, typename Value>
+SpillStatistics CacheManager<Key, Value>::getSpillStatistics() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return spillTier ? spillTier->getStatistics() : SpillStatistics();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::enableCompression(double share) {
+    static_assert(SpillCodec<Value>::supported, "compression needs a SpillCodec for the value type");
+    if (!(share > 0.0 && share < 1.0)) {
+        throw std::invalid_argument("compressed share must be between 0 and 1");
+    }
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    compressedShare = share;
+    if (!compressedTier) {
+        compressedTier = std::make_unique<CompressedTier<Key, Value>>(compressedCapacity());
+    }
+    // Shrinking the shards moves their coldest entries into the new tier
+    recreateCache();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::disableCompression() {
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    if (!compressedTier) {
+        return;
+    }
+    retractReadView();
+    compressedTier.reset();
+    compressedShare = 0.0;
+    recreateCache();
+}
+
+template<typename Key, typename Value>
+bool CacheManager<Key, Value>::hasCompression() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return compressedTier != nullptr;
+}
+
+template<typename Key, typename Value>
+CompressionStatistics CacheManager<Key, Value>::getCompressionStatistics() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return compressedTier ? compressedTier->getStatistics() : CompressionStatistics();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::enableAutoTuning() {
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    if (policyTuner) {
+        return;
+    }
+    retractReadView();
+    policyTuner = std::make_unique<PolicyTuner<Key, Value>>(currentPolicy, cacheCapacity - compressedCapacity());
+    publishReadView();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::disableAutoTuning() {
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    if (!policyTuner) {
+        return;
+    }
+    retractReadView();
+    policyTuner.reset();
+    publishReadView();
+}
+
+template<typename Key, typename Value>
+bool CacheManager<Key, Value>::hasAutoTuning() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return policyTuner != nullptr;
+}
+
+template<typename Key, typename Value>
+TuningStatistics CacheManager<Key, Value>::getTuningStatistics() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return policyTuner ? policyTuner->getStatistics() : TuningStatistics();
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::pin(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    cache->pin(key);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    shardFor(key).pin(key);
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::unpin(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    cache->unpin(key);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    shardFor(key).unpin(key);
 }
 
 template<typename Key, typename Value>
 bool CacheManager<Key, Value>::isPinned(const Key& key) const {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    return cache->isPinned(key);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return shardFor(key).isPinned(key);
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::prefetch(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    cache->prefetch(key, value);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    discardFromTiers(key);
+    shardFor(key).prefetch(key, value);
+    flushEvictions(compressedTier.get(), spillTier.get());
+    if (policyTuner) {
+        policyTuner->recordInsert(key, value);
+    }
 }
 
 template<typename Key, typename Value>
 CacheStatistics CacheManager<Key, Value>::getStatistics() const {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    return cache->getStatistics();
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    CacheStatistics merged = shards.front()->getStatistics();
+    for (size_t i = 1; i < shards.size(); ++i) {
+        merged.accumulate(shards[i]->getStatistics());
+    }
+    merged.accumulate(retiredStats);
+    for (const auto& filter : admissionFilters) {
+        std::lock_guard<std::mutex> filterLock(filter->mutex);
+        merged.admissionsAccepted += filter->accepted;
+        merged.admissionsRejected += filter->rejected;
+    }
+    return merged;
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::resetStatistics() {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    cache->resetStatistics();
+    // Exclusive because retiredStats is read under the shared lock
+    std::unique_lock<std::shared_mutex> lock(managerMutex);
+    for (auto& shard : shards) {
+        shard->resetStatistics();
+    }
+    retiredStats = CacheStatistics();
+    for (auto& filter : admissionFilters) {
+        std::lock_guard<std::mutex> filterLock(filter->mutex);
+        filter->accepted = 0;
+        filter->rejected = 0;
+    }
+    if (compressedTier) {
+        compressedTier->resetStatistics();
+    }
+    if (spillTier) {
+        spillTier->resetStatistics();
+    }
 }
 
 template<typename Key, typename Value>
@@ -661,77 +2950,450 @@ void CacheManager<Key, Value>::showCacheAnalytics() const {
     
     std::cout << "\n======== Cache Analytics Dashboard ========\n";
     std::cout << "Policy: ";
-    switch (currentPolicy) {
+    switch (getPolicy()) {
         case CachePolicy::LRU: std::cout << "LRU (Least Recently Used)"; break;
         case CachePolicy::LFU: std::cout << "LFU (Least Frequently Used)"; break;
         case CachePolicy::FIFO: std::cout << "FIFO (First In, First Out)"; break;
         case CachePolicy::LIFO: std::cout << "LIFO (Last In, First Out)"; break;
+        case CachePolicy::ARC: std::cout << "ARC (Adaptive Replacement Cache)"; break;
+        case CachePolicy::CLOCK: std::cout << "CLOCK (lock-free hits)"; break;
+        case CachePolicy::CLOCK_PRO: std::cout << "CLOCK-Pro"; break;
     }
     std::cout << "\n";
-    std::cout << "Capacity: " << cacheCapacity << "\n";
-    std::cout << "Current Size: " << cache->size() << "\n";
+    std::cout << "Capacity: " << capacity() << " bytes\n";
+    std::cout << "Shards: " << getShardCount() << "\n";
+    std::cout << "Current Size: " << size() << " entries\n";
+    std::cout << "Resident Bytes: " << stats.residentBytes << "\n";
     std::cout << "Hit Rate: " << std::fixed << std::setprecision(2) << stats.hitRate << "%\n";
     std::cout << "Total Hits: " << stats.hits << "\n";
     std::cout << "Total Misses: " << stats.misses << "\n";
     std::cout << "Total Evictions: " << stats.evictions << "\n";
+    std::cout << "Bytes Evicted: " << stats.bytesEvicted << "\n";
     std::cout << "Pinned Items: " << stats.pinnedItems << "\n";
     std::cout << "Prefetched Items: " << stats.prefetchedItems << "\n";
+    std::cout << "Admission: "
+              << (getAdmissionPolicy() == AdmissionPolicy::TinyLFU ? "TinyLFU" : "None") << "\n";
+    std::cout << "Admissions Accepted: " << stats.admissionsAccepted << "\n";
+    std::cout << "Admissions Rejected: " << stats.admissionsRejected << "\n";
+    if (hasCompression()) {
+        auto compression = getCompressionStatistics();
+        std::cout << "Compressed Tier Hit Rate: " << compression.hitRate << "%\n";
+        std::cout << "Compressed Tier Hits: " << compression.hits << "\n";
+        std::cout << "Compressed Tier Entries: " << compression.residentEntries << "\n";
+        std::cout << "Compressed Tier Bytes: " << compression.residentBytes << " holding "
+                  << compression.rawBytes << " (ratio " << compression.compressionRatio << ")\n";
+        std::cout << "Compression CPU: " << compression.compressNanos / 1000000.0 << " ms compressing, "
+                  << compression.decompressNanos / 1000000.0 << " ms decompressing\n";
+        std::cout << "Incompressible Evictions: " << compression.incompressible << "\n";
+    }
+    if (hasSpillTier()) {
+        auto spillStats = getSpillStatistics();
+        std::cout << "Spill Tier Hit Rate: " << spillStats.hitRate << "%\n";
+        std::cout << "Spill Tier Hits: " << spillStats.hits << "\n";
+        std::cout << "Spill Tier Misses: " << spillStats.misses << "\n";
+        std::cout << "Spill Tier Entries: " << spillStats.residentEntries << "\n";
+        std::cout << "Spill Tier Bytes: " << spillStats.residentBytes << " live / "
+                  << spillStats.fileBytes << " on disk\n";
+        std::cout << "Spill Tier Dropped: " << spillStats.dropped << "\n";
+        std::cout << "Spill Tier Compactions: " << spillStats.compactions << "\n";
+    }
     std::cout << "==========================================\n\n";
 }
 
 template<typename Key, typename Value>
 std::vector<Key> CacheManager<Key, Value>::getHotKeys(size_t count) const {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    auto keys = cache->getKeys();
-    
-    // For now, return first 'count' keys
-    // In a real implementation, you'd sort by access frequency/recency
-    if (keys.size() > count) {
-        keys.resize(count);
+    std::vector<Key> keys;
+    for (auto& hotKey : getHotKeyCounts(count)) {
+        keys.push_back(std::move(hotKey.key));
     }
     return keys;
 }
 
+template<typename Key, typename Value>
+std::vector<HotKey<Key>> CacheManager<Key, Value>::getHotKeyCounts(size_t count) const {
+    // Only the tracked counters are merged, never the whole key set
+    std::unordered_map<Key, uint64_t> merged;
+    for (auto& stripe : hotKeyStripes) {
+        std::lock_guard<std::mutex> stripeLock(stripe.mutex);
+        stripe.hitters.forEach([&merged](const Key& key, uint64_t count) { merged[key] += count; });
+    }
+    
+    std::vector<HotKey<Key>> hottest;
+    hottest.reserve(merged.size());
+    for (auto& entry : merged) {
+        hottest.push_back(HotKey<Key>{entry.first, entry.second});
+    }
+    auto hotter = [](const HotKey<Key>& a, const HotKey<Key>& b) { return a.count > b.count; };
+    if (hottest.size() > count) {
+        std::partial_sort(hottest.begin(), hottest.begin() + count, hottest.end(), hotter);
+        hottest.resize(count);
+    } else {
+        std::sort(hottest.begin(), hottest.end(), hotter);
+    }
+    return hottest;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::forgetHotKey(const Key& key) {
+    for (auto& stripe : hotKeyStripes) {
+        std::lock_guard<std::mutex> stripeLock(stripe.mutex);
+        stripe.hitters.erase(key);
+    }
+}
+
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::warmup(const std::vector<std::pair<Key, Value>>& data) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     for (const auto& pair : data) {
-        cache->prefetch(pair.first, pair.second);
+        discardFromTiers(pair.first);
+        shardFor(pair.first).prefetch(pair.first, pair.second);
     }
+    flushEvictions(compressedTier.get(), spillTier.get());
 }
 
 template<typename Key, typename Value>
-void CacheManager<Key, Value>::optimizeForWorkload() {
-    // This could implement adaptive policy selection based on access patterns
-    // For now, it's a placeholder for future optimization algorithms
-    auto stats = getStatistics();
+void CacheManager<Key, Value>::warmup(std::vector<CacheEntry<Key, Value>> entries) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    for (auto& entry : entries) {
+        discardFromTiers(entry.key);
+        auto& shard = shardFor(entry.key);
+        shard.adopt(std::move(entry));
+    }
+    flushEvictions(compressedTier.get(), spillTier.get());
+}
+
+template<typename Key, typename Value>
+std::vector<KeySnapshot<Key>> CacheManager<Key, Value>::snapshotHotKeys(size_t maxEntries) const {
+    std::vector<KeySnapshot<Key>> keys;
+    {
+        std::shared_lock<std::shared_mutex> lock(managerMutex);
+        for (const auto& shard : shards) {
+            auto shardKeys = shard->snapshot();
+            keys.insert(keys.end(), std::make_move_iterator(shardKeys.begin()),
+                        std::make_move_iterator(shardKeys.end()));
+        }
+    }
     
-    // Simple heuristic: if hit rate is low, consider switching policies
-    if (stats.hitRate < 50.0 && stats.totalAccesses > 100) {
-        std::cout << "Cache performance is suboptimal. Consider switching cache policy.\n";
+    auto hotter = [](const KeySnapshot<Key>& a, const KeySnapshot<Key>& b) {
+        if (a.isPinned != b.isPinned) {
+            return a.isPinned;
+        }
+        return a.accessCount > b.accessCount;
+    };
+    if (keys.size() > maxEntries) {
+        std::partial_sort(keys.begin(), keys.begin() + maxEntries, keys.end(), hotter);
+        keys.resize(maxEntries);
+    } else {
+        std::sort(keys.begin(), keys.end(), hotter);
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::optimizeForWorkload() {
+    std::optional<CachePolicy> choice;
+    {
+        std::shared_lock<std::shared_mutex> lock(managerMutex);
+        if (policyTuner) {
+            choice = policyTuner->evaluate();
+        } else {
+            lock.unlock();
+            // Without shadow simulations only the live hit rate is known
+            auto stats = getStatistics();
+            if (stats.hitRate < 50.0 && stats.totalAccesses > 100) {
+                std::cout << "Cache performance is suboptimal. Consider enabling auto-tuning.\n";
+            }
+            return;
+        }
+    }
+    if (choice) {
+        setPolicy(*choice);
     }
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::recreateCache() {
-    switch (currentPolicy) {
-        case CachePolicy::LRU:
-            cache = std::make_unique<EnhancedLRUCache<Key, Value>>(cacheCapacity);
-            break;
-        case CachePolicy::LFU:
-            cache = std::make_unique<LFUCache<Key, Value>>(cacheCapacity);
-            break;
-        case CachePolicy::FIFO:
-            cache = std::make_unique<FIFOCache<Key, Value>>(cacheCapacity);
-            break;
-        case CachePolicy::LIFO:
-            // For now, use FIFO as LIFO placeholder
-            cache = std::make_unique<FIFOCache<Key, Value>>(cacheCapacity);
-            break;
-        default:
-            cache = std::make_unique<EnhancedLRUCache<Key, Value>>(cacheCapacity);
-            break;
+    // Never create more shards than budget units, every shard must hold at least one
+    size_t hotCapacity = cacheCapacity - compressedCapacity();
+    size_t shardCount = std::max<size_t>(1, std::min(requestedShards, hotCapacity));
+    size_t shardCapacity = (hotCapacity + shardCount - 1) / shardCount;
+    retractReadView();
+    if (compressedTier) {
+        compressedTier->setCapacity(compressedCapacity());
+    }
+    
+    if (policyTuner) {
+        policyTuner->reconfigure(currentPolicy, hotCapacity);
+    }
+    
+    std::vector<CachePtr> newShards;
+    newShards.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        newShards.push_back(makePolicyCache<Key, Value>(currentPolicy, shardCapacity));
+    }
+    
+    // Carry resident entries, pins and access counts over to the new shards;
+    // a smaller budget only evicts what no longer fits
+    std::vector<CachePtr> oldShards = std::move(shards);
+    shards = std::move(newShards);
+    installEvictionListeners();
+    for (auto& shard : oldShards) {
+        auto shardStats = shard->getStatistics();
+        shardStats.residentBytes = 0;
+        shardStats.pinnedItems = 0;
+        retiredStats.accumulate(shardStats);
+        for (auto& entry : shard->drain()) {
+            shardFor(entry.key).adopt(std::move(entry));
+        }
+    }
+    flushEvictions(compressedTier.get(), spillTier.get());
+    recreateAdmissionFilters();
+    publishReadView();
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::recreateAdmissionFilters() {
+    if (admissionPolicy == AdmissionPolicy::None) {
+        admissionFilters.clear();
+        return;
+    }
+    // Keep the popularity history across policy switches and resizes
+    if (admissionFilters.size() == shards.size()) {
+        return;
+    }
+    admissionFilters.clear();
+    for (size_t i = 0; i < shards.size(); ++i) {
+        auto filter = std::make_unique<AdmissionFilter>();
+        filter->sketch.ensureCapacity(shards[i]->size());
+        admissionFilters.push_back(std::move(filter));
+    }
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::publishReadView() {
+    auto view = std::make_unique<ReadView>();
+    for (const auto& shard : shards) {
+        view->shards.push_back(shard.get());
+    }
+    for (const auto& filter : admissionFilters) {
+        view->filters.push_back(filter.get());
+    }
+    view->compressed = compressedTier.get();
+    view->spill = spillTier.get();
+    view->tuner = policyTuner.get();
+    readView.store(view.get());
+    currentView = std::move(view);
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::retractReadView() {
+    // New readers fall back to managerMutex, which the caller holds
+    // exclusively; wait for the ones still using the old shards
+    readView.store(nullptr);
+    readEpoch.synchronize();
+    currentView.reset();
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::shardIndex(const Key& key) const {
+    return shardIndex(key, shards.size());
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::shardIndex(const Key& key, size_t shardCount) const {
+    if (shardCount == 1) {
+        return 0;
+    }
+    // Fibonacci hashing spreads weak std::hash results (e.g. identity for ints)
+    size_t mixed = hasher(key) * static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+    return (mixed >> 16) % shardCount;
+}
+
+template<typename Key, typename Value>
+CacheInterface<Key, Value>& CacheManager<Key, Value>::shardFor(const Key& key) const {
+    return *shards[shardIndex(key)];
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::recordAccess(AdmissionFilter& filter, const Key& key) {
+    // Losing a sample under contention only makes the estimate slightly low
+    std::unique_lock<std::mutex> filterLock(filter.mutex, std::try_to_lock);
+    if (filterLock.owns_lock()) {
+        filter.sketch.increment(key);
+    }
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::recordLookup(const Key& key) {
+    // Counting one lookup in HOT_KEY_SAMPLE keeps the ranking off the hit
+    // path, and like recordAccess a sample lost to contention barely moves it
+    static thread_local uint32_t lookupTick = 0;
+    if (++lookupTick % HOT_KEY_SAMPLE != 0) {
+        return;
+    }
+    auto& stripe = hotKeyStripes[EpochDomain::slotIndex() % HOT_KEY_STRIPES];
+    std::unique_lock<std::mutex> stripeLock(stripe.mutex, std::try_to_lock);
+    if (stripeLock.owns_lock()) {
+        stripe.hitters.increment(key);
+    }
+}
+
+template<typename Key, typename Value>
+bool CacheManager<Key, Value>::admit(size_t index, const Key& key, const Value& value) {
+    auto& shard = *shards[index];
+    auto& filter = *admissionFilters[index];
+    
+    // Updates to resident keys are never filtered
+    if (shard.contains(key)) {
+        recordAccess(filter, key);
+        return true;
+    }
+    
+    // Only the first victim is compared; the check is advisory and may race
+    // with concurrent writers to the same shard
+    auto victim = shard.evictionCandidate(ValueWeigher<Value>::weigh(value));
+    
+    std::lock_guard<std::mutex> filterLock(filter.mutex);
+    filter.sketch.ensureCapacity(shard.size());
+    filter.sketch.increment(key);
+    if (!victim) {
+        return true;
+    }
+    if (filter.sketch.frequency(key) > filter.sketch.frequency(*victim)) {
+        filter.accepted++;
+        return true;
+    }
+    filter.rejected++;
+    return false;
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::compressedCapacity() const {
+    return compressedTier ? static_cast<size_t>(cacheCapacity * compressedShare) : 0;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::installEvictionListeners() {
+    // shards -> compressed tier -> spill tier, skipping the disabled ones
+    SpillTier<Key, Value>* spill = spillTier.get();
+    CompressedTier<Key, Value>* compressed = compressedTier.get();
+    if (compressed) {
+        typename CompressedTier<Key, Value>::OverflowListener toSpill;
+        if (spill) {
+            toSpill = [spill](const Key& key, const Value& value) { spill->spill(key, value); };
+        }
+        compressed->setOverflowListener(toSpill);
+    }
+    typename CacheInterface<Key, Value>::EvictionListener fromShards;
+    if (compressed || spill) {
+        // Runs under the shard lock: queue only, no compression or file I/O
+        fromShards = [this, compressed, spill](const Key& key, const Value& value) {
+            uint64_t invalidations = compressed ? compressed->getInvalidations() : spill->getInvalidations();
+            pendingVictims().push_back(Victim{this, key, value, invalidations});
+        };
+    }
+    for (auto& shard : shards) {
+        shard->setEvictionListener(fromShards);
+    }
+}
+
+template<typename Key, typename Value>
+std::vector<typename CacheManager<Key, Value>::Victim>& CacheManager<Key, Value>::pendingVictims() {
+    thread_local std::vector<Victim> victims;
+    return victims;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::flushEvictions(CompressedTier<Key, Value>* compressed,
+                                              SpillTier<Key, Value>* spill) {
+    auto& victims = pendingVictims();
+    if (victims.empty()) {
+        return;
+    }
+    for (const auto& victim : victims) {
+        // Left behind by a shard call that threw in another manager
+        if (victim.owner != this) {
+            continue;
+        }
+        if (compressed) {
+            if (compressed->getInvalidations() == victim.invalidations) {
+                compressed->store(victim.key, victim.value, ValueWeigher<Value>::weigh(victim.value));
+            }
+        } else if (spill && spill->getInvalidations() == victim.invalidations) {
+            spill->spill(victim.key, victim.value);
+        }
+    }
+    victims.clear();
+}
+
+template<typename Key, typename Value>
+std::optional<Value> CacheManager<Key, Value>::promoteFromTiers(CompressedTier<Key, Value>* compressed,
+                                                                SpillTier<Key, Value>* spill,
+                                                                CacheInterface<Key, Value>& shard,
+                                                                const Key& key) {
+    std::optional<Value> value;
+    if (compressed) {
+        value = promote(*compressed, shard, key);
+    }
+    if (!value && spill) {
+        value = promote(*spill, shard, key);
+    }
+    // Making room for the promoted entry may have evicted others
+    flushEvictions(compressed, spill);
+    return value;
+}
+
+template<typename Key, typename Value>
+template<typename Tier>
+std::optional<Value> CacheManager<Key, Value>::promote(Tier& tier, CacheInterface<Key, Value>& shard,
+                                                       const Key& key) {
+    uint64_t invalidations = tier.getInvalidations();
+    auto value = tier.take(key);
+    if (!value) {
+        return std::nullopt;
+    }
+    // A put that raced with us keeps its newer value
+    CacheEntry<Key, Value> entry(key, *value);
+    entry.accessCount = 1;
+    shard.adopt(std::move(entry));
+    if (tier.getInvalidations() != invalidations) {
+        // Removed while we were moving it; the caller still gets its value
+        shard.remove(key);
+    }
+    return value;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::discardFromTiers(const Key& key) {
+    if (compressedTier) {
+        compressedTier->discard(key);
+    }
+    if (spillTier) {
+        spillTier->discard(key);
+    }
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::invalidateTiers(const Key& key) {
+    // Top down, in the direction entries move
+    if (compressedTier) {
+        compressedTier->remove(key);
+    }
+    if (spillTier) {
+        spillTier->remove(key);
+    }
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::invalidateTiersIf(const std::function<bool(const Key&)>& predicate) {
+    size_t removed = 0;
+    if (compressedTier) {
+        removed += compressedTier->removeIf(predicate);
+    }
+    if (spillTier) {
+        removed += spillTier->removeIf(predicate);
     }
+    return removed;
 }
 
 } // namespace mtfs::cache
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+
+namespace mtfs::cache {
+
+// Epoch-based reclamation for read-mostly structures. Readers bracket each
+// lookup with a Guard, which only touches a counter in a slot picked by
+// thread id, so readers on different cores do not share cache lines.
+// A writer that has unlinked something calls synchronize() before freeing
+// it: it flips the epoch twice and waits for the readers of each retired
+// epoch to leave, after which no reader can still hold a pointer it loaded
+// before the unlink. Readers never block; synchronize() spins and yields.
+// All accesses that publish or read guarded pointers must be seq_cst.
+class EpochDomain {
+public:
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain)
+            : counter(&domain.slots[slotIndex()].active[domain.epoch.load() & 1]) {
+            counter->fetch_add(1);
+        }
+        ~Guard() { counter->fetch_sub(1); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        std::atomic<size_t>* counter;
+    };
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    void synchronize() {
+        // One flip is not enough: a reader may have loaded the previous
+        // epoch just before the last synchronize() checked its parity
+        for (int phase = 0; phase < 2; ++phase) {
+            size_t retired = epoch.fetch_add(1) & 1;
+            for (auto& slot : slots) {
+                while (slot.active[retired].load() != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    static constexpr size_t SLOTS = 64;
+
+    // Stable per-thread slot, also usable for other per-thread counters
+    static size_t slotIndex() {
+        thread_local const size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % SLOTS;
+        return index;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> active[2] = {};
+    };
+
+    std::atomic<size_t> epoch{0};
+    Slot slots[SLOTS];
+};
+
+} // namespace mtfs::cache
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace mtfs::cache {
+
+// Count-min sketch of 4-bit saturating counters used as the TinyLFU
+// popularity estimate. Each key touches one counter in each of four rows and
+// its frequency is the minimum of them. Once the number of recorded accesses
+// reaches the sample size every counter is halved, so old popularity fades
+// and the estimate tracks the recent workload. Not thread safe.
+template<typename Key>
+class FrequencySketch {
+public:
+    explicit FrequencySketch(size_t expectedEntries = 0);
+    
+    // Grow the table so it stays accurate for about this many keys
+    void ensureCapacity(size_t expectedEntries);
+    void increment(const Key& key);
+    // Estimated recent access count, saturating at 15
+    unsigned frequency(const Key& key) const;
+    void clear();
+    
+    size_t getSampleSize() const { return sampleSize; }
+
+private:
+    static constexpr int DEPTH = 4;
+    static constexpr unsigned MAX_COUNT = 15;
+    static constexpr size_t MIN_ENTRIES = 64;
+    
+    size_t counterIndex(uint64_t hash, int row) const;
+    uint64_t spread(const Key& key) const;
+    void age();
+    
+    std::vector<uint64_t> table;  // sixteen 4-bit counters per word
+    size_t counterMask{0};
+    size_t sampleSize{0};
+    size_t additions{0};
+    std::hash<Key> hasher;
+};
+
+} // namespace mtfs::cache
+
+// Include implementation files
+#include "frequency_sketch.tpp"
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+
+namespace mtfs::cache {
+
+// ===== FrequencySketch Implementation =====
+
+template<typename Key>
+FrequencySketch<Key>::FrequencySketch(size_t expectedEntries) {
+    ensureCapacity(expectedEntries);
+}
+
+template<typename Key>
+void FrequencySketch<Key>::ensureCapacity(size_t expectedEntries) {
+    size_t entries = std::max(expectedEntries, MIN_ENTRIES);
+    size_t words = 1;
+    while (words < entries) {
+        words <<= 1;
+    }
+    if (words <= table.size()) {
+        return;
+    }
+    
+    // Resizing forgets history, the estimate rebuilds within one sample period
+    table.assign(words, 0);
+    counterMask = words * 16 - 1;
+    sampleSize = 10 * words;
+    additions = 0;
+}
+
+template<typename Key>
+void FrequencySketch<Key>::increment(const Key& key) {
+    uint64_t hash = spread(key);
+    bool added = false;
+    for (int row = 0; row < DEPTH; ++row) {
+        size_t index = counterIndex(hash, row);
+        uint64_t& word = table[index >> 4];
+        unsigned shift = static_cast<unsigned>(index & 15) * 4;
+        if (((word >> shift) & 0xF) < MAX_COUNT) {
+            word += uint64_t{1} << shift;
+            added = true;
+        }
+    }
+    
+    if (added && ++additions >= sampleSize) {
+        age();
+    }
+}
+
+template<typename Key>
+unsigned FrequencySketch<Key>::frequency(const Key& key) const {
+    uint64_t hash = spread(key);
+    unsigned estimate = MAX_COUNT;
+    for (int row = 0; row < DEPTH; ++row) {
+        size_t index = counterIndex(hash, row);
+        unsigned shift = static_cast<unsigned>(index & 15) * 4;
+        unsigned count = static_cast<unsigned>((table[index >> 4] >> shift) & 0xF);
+        estimate = std::min(estimate, count);
+    }
+    return estimate;
+}
+
+template<typename Key>
+void FrequencySketch<Key>::clear() {
+    std::fill(table.begin(), table.end(), 0);
+    additions = 0;
+}
+
+template<typename Key>
+size_t FrequencySketch<Key>::counterIndex(uint64_t hash, int row) const {
+    // Independent-enough row hashes derived from one 64-bit hash
+    static constexpr uint64_t seeds[DEPTH] = {
+        0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+        0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+    };
+    uint64_t h = (hash + seeds[row]) * seeds[row];
+    h ^= h >> 32;
+    return static_cast<size_t>(h) & counterMask;
+}
+
+template<typename Key>
+uint64_t FrequencySketch<Key>::spread(const Key& key) const {
+    // std::hash may be the identity (integers), so mix before splitting rows
+    uint64_t h = static_cast<uint64_t>(hasher(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template<typename Key>
+void FrequencySketch<Key>::age() {
+    // Halve every counter in place: shift the word and drop the bit that
+    // crossed into the neighbouring counter
+    for (auto& word : table) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    additions /= 2;
+}
+
+} // namespace mtfs::cache
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace mtfs::cache {
+
+// A key with its estimated recent access count
+template<typename Key>
+struct HotKey {
+    Key key;
+    uint64_t count{0};
+};
+
+// Top-K tracker in the Space-Saving family. A fixed number of counters
+// follow the most accessed keys and sit in a min-heap, so an access to a
+// tracked key is one hash lookup plus a short sift. Other keys are counted
+// in a small count-min sketch and only take over the smallest counter once
+// their estimate beats it, which keeps one-off keys from churning the
+// counters. Every sampleSize accesses all counts are halved, so keys that
+// went cold fall behind ones that are hot now. Not thread safe.
+template<typename Key>
+class HeavyHitters {
+public:
+    explicit HeavyHitters(size_t counters = DEFAULT_COUNTERS);
+
+    void increment(const Key& key);
+    void erase(const Key& key);
+    void clear();
+    // The k highest counts, highest first
+    std::vector<HotKey<Key>> top(size_t k) const;
+    // Visit every tracked key, in no particular order
+    void forEach(const std::function<void(const Key&, uint64_t)>& visit) const;
+
+    static constexpr size_t DEFAULT_COUNTERS = 256;
+
+private:
+    static constexpr int DEPTH = 4;
+    static constexpr size_t SKETCH_WIDTH_FACTOR = 8;  // Sketch columns per counter
+    static constexpr size_t SAMPLE_FACTOR = 64;       // Accesses between halvings, per counter
+
+    using PositionMap = std::unordered_map<Key, size_t>;
+    struct Counter {
+        // Key and heap index; unlike iterators, element addresses survive
+        // the map rehashing
+        typename PositionMap::value_type* entry;
+        uint64_t count;
+    };
+
+    uint64_t sketchIncrement(const Key& key);
+    void swapCounters(size_t a, size_t b);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void age();
+
+    std::vector<Counter> heap;  // Min-heap on count
+    PositionMap positions;
+    std::vector<uint32_t> sketch;  // Allocated on first use
+    size_t maxCounters;
+    size_t sketchMask;
+    size_t sampleSize;
+    size_t additions{0};
+    std::hash<Key> hasher;
+};
+
+} // namespace mtfs::cache
+
+// Include implementation files
+#include "heavy_hitters.tpp"
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+
+namespace mtfs::cache {
+
+// ===== HeavyHitters Implementation =====
+
+template<typename Key>
+HeavyHitters<Key>::HeavyHitters(size_t counters) : maxCounters(std::max<size_t>(1, counters)) {
+    size_t width = 1;
+    while (width < maxCounters * SKETCH_WIDTH_FACTOR) {
+        width <<= 1;
+    }
+    sketchMask = width - 1;
+    sampleSize = maxCounters * SAMPLE_FACTOR;
+}
+
+template<typename Key>
+void HeavyHitters<Key>::increment(const Key& key) {
+    if (++additions >= sampleSize) {
+        age();
+    }
+
+    auto found = positions.find(key);
+    if (found != positions.end()) {
+        size_t index = found->second;
+        heap[index].count++;
+        siftDown(index);
+        return;
+    }
+    if (heap.size() < maxCounters) {
+        auto entry = positions.emplace(key, heap.size()).first;
+        heap.push_back(Counter{&*entry, 1});
+        siftUp(heap.size() - 1);
+        return;
+    }
+
+    uint64_t estimate = sketchIncrement(key);
+    if (estimate <= heap.front().count) {
+        return;
+    }
+    // Take over the smallest counter, reusing its map node
+    auto node = positions.extract(heap.front().entry->first);
+    node.key() = key;
+    heap.front().entry = &*positions.insert(std::move(node)).position;
+    heap.front().count = estimate;
+    siftDown(0);
+}
+
+template<typename Key>
+void HeavyHitters<Key>::erase(const Key& key) {
+    auto found = positions.find(key);
+    if (found == positions.end()) {
+        return;
+    }
+    size_t index = found->second;
+    size_t last = heap.size() - 1;
+    if (index != last) {
+        // The last counter fills the hole and may belong either way from there
+        swapCounters(index, last);
+    }
+    positions.erase(found);
+    heap.pop_back();
+    if (index < heap.size()) {
+        // If it moved up, its old parent now at index already fits there
+        siftUp(index);
+        siftDown(index);
+    }
+}
+
+template<typename Key>
+void HeavyHitters<Key>::clear() {
+    heap.clear();
+    positions.clear();
+    std::fill(sketch.begin(), sketch.end(), 0);
+    additions = 0;
+}
+
+template<typename Key>
+std::vector<HotKey<Key>> HeavyHitters<Key>::top(size_t k) const {
+    std::vector<HotKey<Key>> result;
+    result.reserve(heap.size());
+    for (const auto& counter : heap) {
+        result.push_back(HotKey<Key>{counter.entry->first, counter.count});
+    }
+    auto hotter = [](const HotKey<Key>& a, const HotKey<Key>& b) { return a.count > b.count; };
+    if (result.size() > k) {
+        std::partial_sort(result.begin(), result.begin() + k, result.end(), hotter);
+        result.resize(k);
+    } else {
+        std::sort(result.begin(), result.end(), hotter);
+    }
+    return result;
+}
+
+template<typename Key>
+void HeavyHitters<Key>::forEach(const std::function<void(const Key&, uint64_t)>& visit) const {
+    for (const auto& counter : heap) {
+        visit(counter.entry->first, counter.count);
+    }
+}
+
+template<typename Key>
+uint64_t HeavyHitters<Key>::sketchIncrement(const Key& key) {
+    if (sketch.empty()) {
+        sketch.assign(DEPTH * (sketchMask + 1), 0);
+    }
+    uint64_t hash = static_cast<uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ULL;
+    uint64_t estimate = UINT32_MAX;
+    for (int row = 0; row < DEPTH; ++row) {
+        // Rows use different 16-bit slices of the mixed hash
+        size_t column = static_cast<size_t>((hash >> (16 * row)) ^ (hash >> 40)) & sketchMask;
+        uint32_t& counter = sketch[row * (sketchMask + 1) + column];
+        if (counter < UINT32_MAX) {
+            counter++;
+        }
+        estimate = std::min<uint64_t>(estimate, counter);
+    }
+    return estimate;
+}
+
+template<typename Key>
+void HeavyHitters<Key>::swapCounters(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    heap[a].entry->second = a;
+    heap[b].entry->second = b;
+}
+
+template<typename Key>
+void HeavyHitters<Key>::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (heap[parent].count <= heap[index].count) {
+            break;
+        }
+        swapCounters(parent, index);
+        index = parent;
+    }
+}
+
+template<typename Key>
+void HeavyHitters<Key>::siftDown(size_t index) {
+    while (true) {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        if (left < heap.size() && heap[left].count < heap[smallest].count) {
+            smallest = left;
+        }
+        if (right < heap.size() && heap[right].count < heap[smallest].count) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+        swapCounters(smallest, index);
+        index = smallest;
+    }
+}
+
+template<typename Key>
+void HeavyHitters<Key>::age() {
+    // Halving keeps the heap order
+    for (auto& counter : heap) {
+        counter.count /= 2;
+    }
+    for (auto& counter : sketch) {
+        counter /= 2;
+    }
+    additions = 0;
+}
+
+} // namespace mtfs::cache
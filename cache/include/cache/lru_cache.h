@@ -78,6 +78,34 @@ public:
         return result;
     }
 
+    void remove(const Key& key) {
+        EnterCriticalSection(&cs_);
+        auto it = cache_map_.find(key);
+        if (it != cache_map_.end()) {
+            access_list_.erase(it->second.first);
+            cache_map_.erase(it);
+            LOG_DEBUG("Cache remove: " + toString(key));
+        }
+        LeaveCriticalSection(&cs_);
+    }
+
+    template<typename Predicate>
+    size_t removeIf(Predicate predicate) {
+        EnterCriticalSection(&cs_);
+        size_t removed = 0;
+        for (auto it = access_list_.begin(); it != access_list_.end();) {
+            if (predicate(it->first)) {
+                cache_map_.erase(it->first);
+                it = access_list_.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+        LeaveCriticalSection(&cs_);
+        return removed;
+    }
+
     void clear() {
         EnterCriticalSection(&cs_);
         cache_map_.clear();
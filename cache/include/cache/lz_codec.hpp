@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace mtfs::cache {
+
+// Byte-oriented LZ77 codec in the style of LZ4: a greedy matcher with a
+// small hash table on the way in, and plain copies on the way out. It
+// trades ratio for speed, which suits text such as logs that are
+// decompressed on every cache hit.
+//
+// Each sequence is a token (literal count in the high nibble, match length
+// minus MIN_MATCH in the low one, 15 meaning more length bytes follow),
+// the literals, then a 16-bit little-endian offset and the extra match
+// length bytes. The last sequence has literals only.
+namespace lz {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr size_t TAIL_LITERALS = 5;  // The last bytes never start a match
+constexpr size_t HASH_BITS = 12;
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+inline void writeLength(std::string& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+inline void writeSequence(std::string& out, const unsigned char* literals, size_t literalCount,
+                          size_t offset, size_t matchLength) {
+    size_t extraMatch = matchLength - MIN_MATCH;
+    unsigned char token = static_cast<unsigned char>((literalCount < 15 ? literalCount : 15) << 4);
+    if (matchLength > 0) {
+        token |= static_cast<unsigned char>(extraMatch < 15 ? extraMatch : 15);
+    }
+    out.push_back(static_cast<char>(token));
+    if (literalCount >= 15) {
+        writeLength(out, literalCount - 15);
+    }
+    out.append(reinterpret_cast<const char*>(literals), literalCount);
+    if (matchLength == 0) {
+        return;
+    }
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (extraMatch >= 15) {
+        writeLength(out, extraMatch - 15);
+    }
+}
+
+inline bool readLength(const unsigned char*& in, const unsigned char* end, size_t& length) {
+    unsigned char byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace lz
+
+// Compress size bytes into out. Returns false, leaving out unspecified, if
+// the result would not be at least an eighth smaller than the input.
+inline bool lzCompress(const char* data, size_t size, std::string& out) {
+    out.clear();
+    out.reserve(size);
+    const auto* in = reinterpret_cast<const unsigned char*>(data);
+    size_t anchor = 0;
+    if (size > lz::MIN_MATCH + lz::TAIL_LITERALS) {
+        const size_t matchLimit = size - lz::TAIL_LITERALS;
+        uint32_t table[size_t(1) << lz::HASH_BITS] = {};  // Position + 1, 0 when empty
+        size_t pos = 0;
+        while (pos + lz::MIN_MATCH <= matchLimit) {
+            uint32_t sequence = lz::read32(in + pos);
+            uint32_t& slot = table[lz::hash(sequence)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(pos + 1);
+            if (candidate == 0 || pos - (candidate - 1) > lz::MAX_OFFSET ||
+                lz::read32(in + candidate - 1) != sequence) {
+                // Skip faster through data that does not match
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+            size_t match = candidate - 1;
+            size_t length = lz::MIN_MATCH;
+            while (pos + length < matchLimit && in[match + length] == in[pos + length]) {
+                length++;
+            }
+            lz::writeSequence(out, in + anchor, pos - anchor, pos - match, length);
+            pos += length;
+            anchor = pos;
+            if (out.size() >= size - size / 8) {
+                return false;
+            }
+        }
+    }
+    lz::writeSequence(out, in + anchor, size - anchor, 0, 0);
+    return out.size() < size - size / 8;
+}
+
+// Decompress into out, which ends up exactly rawSize bytes long. Returns
+// false on corrupt input.
+inline bool lzDecompress(const char* data, size_t size, size_t rawSize, std::string& out) {
+    out.resize(rawSize);
+    const auto* in = reinterpret_cast<const unsigned char*>(data);
+    const auto* end = in + size;
+    size_t written = 0;
+    while (in < end) {
+        unsigned char token = *in++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !lz::readLength(in, end, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(end - in) || literalCount > rawSize - written) {
+            return false;
+        }
+        std::memcpy(&out[0] + written, in, literalCount);
+        in += literalCount;
+        written += literalCount;
+        if (in == end) {
+            break;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t matchLength = (token & 15);
+        if (matchLength == 15 && !lz::readLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += lz::MIN_MATCH;
+        if (offset == 0 || offset > written || matchLength > rawSize - written) {
+            return false;
+        }
+        char* target = &out[0] + written;
+        const char* source = target - offset;
+        if (offset >= matchLength) {
+            std::memcpy(target, source, matchLength);
+        } else {
+            // The match overlaps what it produces, e.g. a run of one byte
+            for (size_t i = 0; i < matchLength; ++i) {
+                target[i] = source[i];
+            }
+        }
+        written += matchLength;
+    }
+    return written == rawSize;
+}
+
+} // namespace mtfs::cache
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mtfs::cache {
+
+// Collapses concurrent loads of the same key into one. The first caller for a
+// key runs the loader; callers arriving while it is in flight block and get
+// the same result, or the same exception. Once the load finishes the key is
+// forgotten, so later callers start a fresh load.
+template<typename Key, typename Value>
+class SingleFlight {
+public:
+    // `shared` is set when this caller reused another caller's load
+    Value run(const Key& key, const std::function<Value()>& loader, bool* shared = nullptr);
+    
+    size_t getLoads() const { return loads.load(); }
+    size_t getCoalesced() const { return coalesced.load(); }
+    void resetCounters();
+
+private:
+    struct Call {
+        std::promise<Value> promise;
+        std::shared_future<Value> result;
+    };
+    
+    std::unordered_map<Key, std::shared_ptr<Call>> calls;
+    std::mutex callsMutex;
+    std::atomic<size_t> loads{0};
+    std::atomic<size_t> coalesced{0};
+};
+
+} // namespace mtfs::cache
+
+// Include implementation files
+#include "single_flight.tpp"
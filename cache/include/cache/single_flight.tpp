@@ -0,0 +1,51 @@
+#pragma once
+
+namespace mtfs::cache {
+
+// ===== SingleFlight Implementation =====
+
+template<typename Key, typename Value>
+Value SingleFlight<Key, Value>::run(const Key& key, const std::function<Value()>& loader, bool* shared) {
+    std::shared_ptr<Call> call;
+    bool leader = false;
+    {
+        std::lock_guard<std::mutex> lock(callsMutex);
+        auto it = calls.find(key);
+        if (it != calls.end()) {
+            call = it->second;
+        } else {
+            call = std::make_shared<Call>();
+            call->result = call->promise.get_future().share();
+            calls.emplace(key, call);
+            leader = true;
+        }
+    }
+    
+    if (shared) {
+        *shared = !leader;
+    }
+    if (!leader) {
+        coalesced++;
+        return call->result.get();
+    }
+    
+    loads++;
+    try {
+        call->promise.set_value(loader());
+    } catch (...) {
+        call->promise.set_exception(std::current_exception());
+    }
+    {
+        std::lock_guard<std::mutex> lock(callsMutex);
+        calls.erase(key);
+    }
+    return call->result.get();
+}
+
+template<typename Key, typename Value>
+void SingleFlight<Key, Value>::resetCounters() {
+    loads = 0;
+    coalesced = 0;
+}
+
+} // namespace mtfs::cache
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+namespace mtfs::cache {
+
+// Turns cache values into the bytes kept in the spill file. Trivially
+// copyable values are stored as-is; other types need a specialization and
+// cannot be spilled without one.
+template<typename Value, typename Enable = void>
+struct SpillCodec {
+    static constexpr bool supported = false;
+    static bool encode(const Value&, std::string&) { return false; }
+    static std::optional<Value> decode(std::string) { return std::nullopt; }
+};
+
+template<typename Value>
+struct SpillCodec<Value, std::enable_if_t<std::is_trivially_copyable_v<Value>>> {
+    static constexpr bool supported = true;
+    static bool encode(const Value& value, std::string& out) {
+        out.assign(reinterpret_cast<const char*>(&value), sizeof(Value));
+        return true;
+    }
+    static std::optional<Value> decode(std::string bytes) {
+        if (bytes.size() != sizeof(Value)) {
+            return std::nullopt;
+        }
+        Value value;
+        std::memcpy(&value, bytes.data(), sizeof(Value));
+        return value;
+    }
+};
+
+template<>
+struct SpillCodec<std::string> {
+    static constexpr bool supported = true;
+    static bool encode(const std::string& value, std::string& out) {
+        out = value;
+        return true;
+    }
+    static std::optional<std::string> decode(std::string bytes) { return bytes; }
+};
+
+// SharedBuffer
+template<>
+struct SpillCodec<std::shared_ptr<const std::string>> {
+    static constexpr bool supported = true;
+    static bool encode(const std::shared_ptr<const std::string>& value, std::string& out) {
+        if (!value) {
+            return false;
+        }
+        out = *value;
+        return true;
+    }
+    static std::optional<std::shared_ptr<const std::string>> decode(std::string bytes) {
+        return std::make_shared<const std::string>(std::move(bytes));
+    }
+};
+
+struct SpillStatistics {
+    size_t hits{0};           // Lookups served from the spill file
+    size_t misses{0};         // Lookups that missed both tiers
+    size_t spilled{0};        // Evicted entries appended to the spill file
+    size_t dropped{0};        // Spilled entries discarded to stay in budget
+    size_t residentEntries{0};
+    size_t residentBytes{0};  // Live bytes in the spill file
+    size_t fileBytes{0};      // Size of the spill file, garbage included
+    size_t compactions{0};
+    size_t writeErrors{0};
+    double hitRate{0.0};
+
+    void updateHitRate() {
+        size_t total = hits + misses;
+        hitRate = total > 0 ? (static_cast<double>(hits) / total) * 100.0 : 0.0;
+    }
+};
+
+// Second cache tier on local disk. Entries evicted from memory are appended
+// to a spill file and found again through an in-memory index of offsets;
+// a hit removes the entry from the tier so it can move back into memory.
+// The file only grows: replaced, removed and promoted entries leave garbage
+// behind, and a background thread rewrites the live entries into a fresh
+// file once garbage outweighs them. The disk budget is enforced by dropping
+// the oldest spilled entries. The file is scratch space, it is recreated
+// empty on construction and deleted on destruction.
+template<typename Key, typename Value>
+class SpillTier {
+public:
+    SpillTier(std::string basePath, size_t capacityBytes);
+    ~SpillTier();
+
+    SpillTier(const SpillTier&) = delete;
+    SpillTier& operator=(const SpillTier&) = delete;
+
+    // Append an evicted entry, replacing any older copy
+    void spill(const Key& key, const Value& value);
+    // Remove and return the spilled copy, counting a tier hit or miss
+    std::optional<Value> take(const Key& key);
+    bool contains(const Key& key) const;
+    // Invalidate the spilled copy
+    void remove(const Key& key);
+    // Drop a copy that is about to be replaced in memory; unlike remove()
+    // this leaves concurrent promotions alone
+    void discard(const Key& key);
+    size_t removeIf(const std::function<bool(const Key&)>& predicate);
+    void clear();
+    size_t capacity() const { return maxBytes; }
+
+    // Bumped by remove(), removeIf() and clear(); lets a promotion that
+    // raced with an invalidation notice it
+    uint64_t getInvalidations() const { return invalidations.load(); }
+
+    // Rewrite the live entries now if garbage outweighs them
+    void compact();
+
+    SpillStatistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    struct Location {
+        uint64_t offset;
+        uint32_t length;
+        uint64_t sequence;  // Spill order, survives compaction
+    };
+
+    static constexpr uint64_t MIN_COMPACT_BYTES = 1 << 20;  // Smaller files are never compacted
+    static constexpr size_t COPY_CHUNK = 1 << 16;
+
+    std::string filePath(uint64_t fileGeneration) const;
+    bool openFile();
+    void erase(typename std::unordered_map<Key, Location>::iterator it);
+    void dropOldest(size_t incomingBytes);
+    bool needsCompaction() const;
+    static bool copyBytes(std::istream& source, uint64_t offset, uint32_t length, std::ostream& target);
+    void compactLoop();
+
+    const std::string basePath;
+    const size_t maxBytes;
+    std::fstream file;
+    uint64_t fileEnd{0};
+    uint64_t generation{0};  // Suffix of the current file, bumped on every rewrite
+    uint64_t nextSequence{0};
+    size_t liveBytes{0};
+    std::unordered_map<Key, Location> index;
+    std::deque<std::pair<Key, uint64_t>> spillOrder;  // Oldest first; stale pairs skipped
+    std::atomic<uint64_t> invalidations{0};
+    SpillStatistics stats;
+    mutable std::mutex spillMutex;
+    std::mutex compactMutex;  // One compaction at a time
+
+    bool stopping{false};
+    std::condition_variable compactWake;
+    std::thread compactor;
+};
+
+} // namespace mtfs::cache
+
+// Include implementation files
+#include "spill_tier.tpp"
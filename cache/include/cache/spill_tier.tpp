@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+namespace mtfs::cache {
+
+// ===== SpillTier Implementation =====
+
+template<typename Key, typename Value>
+SpillTier<Key, Value>::SpillTier(std::string basePath, size_t capacityBytes)
+    : basePath(std::move(basePath)), maxBytes(capacityBytes) {
+    openFile();
+    compactor = std::thread([this] { compactLoop(); });
+}
+
+template<typename Key, typename Value>
+SpillTier<Key, Value>::~SpillTier() {
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        stopping = true;
+    }
+    compactWake.notify_all();
+    compactor.join();
+    file.close();
+    std::remove(filePath(generation).c_str());
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::spill(const Key& key, const Value& value) {
+    std::string bytes;
+    bool encoded = SpillCodec<Value>::encode(value, bytes) && bytes.size() <= maxBytes &&
+                   bytes.size() <= UINT32_MAX;
+    bool compactNow = false;
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        // Whatever happens, an older spilled copy is stale now
+        auto existing = index.find(key);
+        if (existing != index.end()) {
+            erase(existing);
+        }
+        if (!encoded) {
+            return;
+        }
+        dropOldest(bytes.size());
+
+        Location location{fileEnd, static_cast<uint32_t>(bytes.size()), nextSequence++};
+        file.seekp(static_cast<std::streamoff>(fileEnd));
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            file.clear();
+            stats.writeErrors++;
+            return;
+        }
+        index.emplace(key, location);
+        spillOrder.emplace_back(key, location.sequence);
+        fileEnd += location.length;
+        liveBytes += location.length;
+        stats.spilled++;
+
+        // Squeeze out the stale pairs once they dominate the queue
+        if (spillOrder.size() > 2 * index.size() + 64) {
+            std::deque<std::pair<Key, uint64_t>> current;
+            for (auto& entry : spillOrder) {
+                auto it = index.find(entry.first);
+                if (it != index.end() && it->second.sequence == entry.second) {
+                    current.push_back(std::move(entry));
+                }
+            }
+            spillOrder.swap(current);
+        }
+        compactNow = needsCompaction();
+    }
+    if (compactNow) {
+        compactWake.notify_one();
+    }
+}
+
+template<typename Key, typename Value>
+std::optional<Value> SpillTier<Key, Value>::take(const Key& key) {
+    std::string bytes;
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            stats.misses++;
+            return std::nullopt;
+        }
+        bytes.resize(it->second.length);
+        file.seekg(static_cast<std::streamoff>(it->second.offset));
+        file.read(&bytes[0], static_cast<std::streamsize>(bytes.size()));
+        bool readOk = static_cast<bool>(file);
+        if (!readOk) {
+            file.clear();
+        }
+        // The copy moves back to memory, its bytes here become garbage
+        erase(it);
+        if (!readOk) {
+            stats.misses++;
+            return std::nullopt;
+        }
+        stats.hits++;
+    }
+    return SpillCodec<Value>::decode(std::move(bytes));
+}
+
+template<typename Key, typename Value>
+bool SpillTier<Key, Value>::contains(const Key& key) const {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    return index.find(key) != index.end();
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    invalidations++;
+    auto it = index.find(key);
+    if (it != index.end()) {
+        erase(it);
+    }
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::discard(const Key& key) {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        erase(it);
+    }
+}
+
+template<typename Key, typename Value>
+size_t SpillTier<Key, Value>::removeIf(const std::function<bool(const Key&)>& predicate) {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    invalidations++;
+    size_t removed = 0;
+    for (auto it = index.begin(); it != index.end();) {
+        if (predicate(it->first)) {
+            liveBytes -= it->second.length;
+            it = index.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    invalidations++;
+    index.clear();
+    spillOrder.clear();
+    liveBytes = 0;
+    // Start a fresh file; a compaction still copying the old one notices
+    // the new generation and gives up
+    file.close();
+    std::remove(filePath(generation).c_str());
+    generation++;
+    openFile();
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::compact() {
+    std::lock_guard<std::mutex> compactLock(compactMutex);
+    std::vector<std::pair<Key, Location>> live;
+    uint64_t sourceGeneration;
+    uint64_t firstUncopied;
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        if (!needsCompaction() || !file.is_open()) {
+            return;
+        }
+        file.flush();
+        sourceGeneration = generation;
+        firstUncopied = nextSequence;
+        live.assign(index.begin(), index.end());
+    }
+
+    // Copy the live entries without the lock, in file order
+    std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) {
+        return a.second.offset < b.second.offset;
+    });
+    const std::string targetPath = filePath(sourceGeneration + 1);
+    std::ifstream source(filePath(sourceGeneration), std::ios::binary);
+    std::fstream target(targetPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    uint64_t targetEnd = 0;
+    std::vector<uint64_t> newOffsets;
+    newOffsets.reserve(live.size());
+    bool copied = source && target;
+    for (size_t i = 0; copied && i < live.size(); ++i) {
+        copied = copyBytes(source, live[i].second.offset, live[i].second.length, target);
+        newOffsets.push_back(targetEnd);
+        targetEnd += live[i].second.length;
+    }
+    source.close();
+
+    std::lock_guard<std::mutex> lock(spillMutex);
+    // Entries spilled while copying are still only in the current file
+    std::vector<std::pair<Key, uint64_t>> appended;
+    if (copied && generation == sourceGeneration) {
+        for (const auto& [key, location] : index) {
+            if (location.sequence < firstUncopied) {
+                continue;
+            }
+            copied = copyBytes(file, location.offset, location.length, target);
+            if (!copied) {
+                break;
+            }
+            appended.emplace_back(key, targetEnd);
+            targetEnd += location.length;
+        }
+    }
+    if (!copied || generation != sourceGeneration || !target.flush()) {
+        // Cleared meanwhile, or an I/O error: keep the current file
+        file.clear();
+        target.close();
+        std::remove(targetPath.c_str());
+        return;
+    }
+
+    for (size_t i = 0; i < live.size(); ++i) {
+        auto it = index.find(live[i].first);
+        if (it != index.end() && it->second.sequence == live[i].second.sequence) {
+            it->second.offset = newOffsets[i];
+        }
+    }
+    for (const auto& [key, offset] : appended) {
+        index.find(key)->second.offset = offset;
+    }
+    file.close();
+    std::remove(filePath(generation).c_str());
+    file = std::move(target);
+    generation++;
+    fileEnd = targetEnd;
+    stats.compactions++;
+}
+
+template<typename Key, typename Value>
+SpillStatistics SpillTier<Key, Value>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    SpillStatistics statsCopy = stats;
+    statsCopy.residentEntries = index.size();
+    statsCopy.residentBytes = liveBytes;
+    statsCopy.fileBytes = fileEnd;
+    statsCopy.updateHitRate();
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::resetStatistics() {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    stats = SpillStatistics();
+}
+
+template<typename Key, typename Value>
+std::string SpillTier<Key, Value>::filePath(uint64_t fileGeneration) const {
+    return basePath + "." + std::to_string(fileGeneration);
+}
+
+template<typename Key, typename Value>
+bool SpillTier<Key, Value>::openFile() {
+    fileEnd = 0;
+    file.open(filePath(generation), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    return file.is_open();
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::erase(typename std::unordered_map<Key, Location>::iterator it) {
+    liveBytes -= it->second.length;
+    index.erase(it);
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::dropOldest(size_t incomingBytes) {
+    while (liveBytes + incomingBytes > maxBytes && !spillOrder.empty()) {
+        auto oldest = std::move(spillOrder.front());
+        spillOrder.pop_front();
+        auto it = index.find(oldest.first);
+        if (it != index.end() && it->second.sequence == oldest.second) {
+            erase(it);
+            stats.dropped++;
+        }
+    }
+}
+
+template<typename Key, typename Value>
+bool SpillTier<Key, Value>::needsCompaction() const {
+    return fileEnd >= MIN_COMPACT_BYTES && fileEnd - liveBytes > liveBytes;
+}
+
+template<typename Key, typename Value>
+bool SpillTier<Key, Value>::copyBytes(std::istream& source, uint64_t offset, uint32_t length,
+                                      std::ostream& target) {
+    char buffer[COPY_CHUNK];
+    source.seekg(static_cast<std::streamoff>(offset));
+    while (length > 0) {
+        uint32_t chunk = std::min<uint32_t>(length, COPY_CHUNK);
+        if (!source.read(buffer, chunk) || !target.write(buffer, chunk)) {
+            return false;
+        }
+        length -= chunk;
+    }
+    return true;
+}
+
+template<typename Key, typename Value>
+void SpillTier<Key, Value>::compactLoop() {
+    std::unique_lock<std::mutex> lock(spillMutex);
+    while (true) {
+        compactWake.wait(lock, [this] { return stopping || needsCompaction(); });
+        if (stopping) {
+            return;
+        }
+        uint64_t before = generation;
+        lock.unlock();
+        compact();
+        lock.lock();
+        // A compaction that failed leaves the garbage in place; retry later
+        // instead of spinning on it
+        if (generation == before && needsCompaction()) {
+            compactWake.wait_for(lock, std::chrono::seconds(1), [this] { return stopping; });
+        }
+    }
+}
+
+} // namespace mtfs::cache
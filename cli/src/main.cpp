@@ -68,12 +68,19 @@ void printUsage() {
               << "  restore-backup <backup_name> [target_directory]\n"
               << "  delete-backup <backup_name>\n"
               << "  list-backups\n"              << "  backup-dashboard\n"
-              << "  set-cache-policy <policy>    # LRU, LFU, FIFO\n"
+              << "  set-cache-policy <policy>    # LRU, LFU, FIFO, LIFO, ARC, CLOCK, CLOCK_PRO\n"
               << "  get-cache-policy\n"
-              << "  resize-cache <size>\n"
+              << "  resize-cache <bytes>\n"
+              << "  set-cache-admission <policy> # NONE, TINYLFU\n"
               << "  pin-file <filename>\n"
               << "  unpin-file <filename>\n"
               << "  prefetch-file <filename>\n"
+              << "  set-prefetch <mode>          # ON, OFF (pattern prefetching)\n"
+              << "  set-cache-ttl <ms>           # 0 disables expiry\n"
+              << "  set-cache-revalidate <mode> [interval_ms]  # ON, OFF (mtime/size check on hits)\n"
+              << "  set-cache-spill <bytes>      # disk tier for evicted files, 0 disables\n"
+              << "  set-cache-compression <pct>  # budget share kept compressed, 0 disables\n"
+              << "  set-cache-autotune <mode>    # ON, OFF (switch policy on shadow hit rates)\n"
               << "  cache-analytics\n"
               << "  hot-files [count]\n"
               << "  show-stats\n"
@@ -93,6 +100,8 @@ int main() {
         // Initialize filesystem with a root directory and auth manager
         const std::string rootPath = "./fs_root";
         auto fs = FileSystem::create(rootPath, &auth);
+        // Reloads the cache snapshot of the previous session in the background
+        fs->mount();
         LOG_INFO("Filesystem initialized at: " + rootPath);
 
         std::string line;
@@ -113,6 +122,7 @@ int main() {
                 }
                 else if (cmd == "exit") {
                     LOG_INFO("Shutting down filesystem");
+                    fs->unmount();
                     break;
                 }
                 else if (cmd == "login") {
@@ -389,15 +399,19 @@ int main() {
                 }
                 else if (cmd == "set-cache-policy") {
                     if (tokens.size() != 2) {
-                        std::cout << "Usage: set-cache-policy <policy>  # LRU, LFU, FIFO" << std::endl;
+                        std::cout << "Usage: set-cache-policy <policy>  # LRU, LFU, FIFO, LIFO, ARC, CLOCK, CLOCK_PRO" << std::endl;
                         continue;
                     }                    std::string policyStr = tokens[1];
                     CachePolicy policy;
                     if (policyStr == "LRU") policy = CachePolicy::LRU;
                     else if (policyStr == "LFU") policy = CachePolicy::LFU;
                     else if (policyStr == "FIFO") policy = CachePolicy::FIFO;
+                    else if (policyStr == "LIFO") policy = CachePolicy::LIFO;
+                    else if (policyStr == "ARC") policy = CachePolicy::ARC;
+                    else if (policyStr == "CLOCK") policy = CachePolicy::CLOCK;
+                    else if (policyStr == "CLOCK_PRO") policy = CachePolicy::CLOCK_PRO;
                     else {
-                        std::cout << "Invalid policy. Use: LRU, LFU, or FIFO" << std::endl;
+                        std::cout << "Invalid policy. Use: LRU, LFU, FIFO, LIFO, ARC, CLOCK, or CLOCK_PRO" << std::endl;
                         continue;
                     }
                     fs->setCachePolicy(policy);
@@ -411,19 +425,39 @@ int main() {
                         case CachePolicy::LFU: policyStr = "LFU"; break;
                         case CachePolicy::FIFO: policyStr = "FIFO"; break;
                         case CachePolicy::LIFO: policyStr = "LIFO"; break;
+                        case CachePolicy::ARC: policyStr = "ARC"; break;
+                        case CachePolicy::CLOCK: policyStr = "CLOCK"; break;
+                        case CachePolicy::CLOCK_PRO: policyStr = "CLOCK_PRO"; break;
                         default: policyStr = "Unknown"; break;
                     }
                     std::cout << "Current cache policy: " << policyStr << std::endl;
                 }
                 else if (cmd == "resize-cache") {
                     if (tokens.size() != 2) {
-                        std::cout << "Usage: resize-cache <size>" << std::endl;
+                        std::cout << "Usage: resize-cache <bytes>" << std::endl;
                         continue;
                     }
                     size_t newSize = std::stoull(tokens[1]);
                     fs->resizeCache(newSize);
-                    std::cout << "Cache resized to: " << newSize << std::endl;
-                    LOG_INFO("Resized cache to: " + std::to_string(newSize));
+                    std::cout << "Cache resized to: " << newSize << " bytes" << std::endl;
+                    LOG_INFO("Resized cache to: " + std::to_string(newSize) + " bytes");
+                }
+                else if (cmd == "set-cache-admission") {
+                    if (tokens.size() != 2) {
+                        std::cout << "Usage: set-cache-admission <policy>  # NONE, TINYLFU" << std::endl;
+                        continue;
+                    }
+                    std::string policyStr = tokens[1];
+                    AdmissionPolicy policy;
+                    if (policyStr == "NONE") policy = AdmissionPolicy::None;
+                    else if (policyStr == "TINYLFU") policy = AdmissionPolicy::TinyLFU;
+                    else {
+                        std::cout << "Invalid admission policy. Use: NONE or TINYLFU" << std::endl;
+                        continue;
+                    }
+                    fs->setCacheAdmissionPolicy(policy);
+                    std::cout << "Cache admission policy set to: " << policyStr << std::endl;
+                    LOG_INFO("Set cache admission policy to: " + policyStr);
                 }
                 else if (cmd == "pin-file") {
                     if (tokens.size() != 2) {
@@ -449,8 +483,75 @@ int main() {
                         continue;
                     }
                     fs->prefetchFile(tokens[1]);
-                    std::cout << "File prefetched: " << tokens[1] << std::endl;
-                    LOG_INFO("Prefetched file: " + tokens[1]);
+                    std::cout << "File queued for prefetch: " << tokens[1] << std::endl;
+                    LOG_INFO("Queued prefetch of file: " + tokens[1]);
+                }
+                else if (cmd == "set-prefetch") {
+                    if (tokens.size() != 2 || (tokens[1] != "ON" && tokens[1] != "OFF")) {
+                        std::cout << "Usage: set-prefetch <mode>  # ON, OFF" << std::endl;
+                        continue;
+                    }
+                    fs->setPrefetchEnabled(tokens[1] == "ON");
+                    std::cout << "Pattern prefetching: " << tokens[1] << std::endl;
+                    LOG_INFO("Set pattern prefetching to: " + tokens[1]);
+                }
+                else if (cmd == "set-cache-ttl") {
+                    if (tokens.size() != 2) {
+                        std::cout << "Usage: set-cache-ttl <ms>  # 0 disables expiry" << std::endl;
+                        continue;
+                    }
+                    auto settings = fs->getCacheValidation();
+                    settings.ttl = std::chrono::milliseconds(std::stoll(tokens[1]));
+                    fs->setCacheValidation(settings);
+                    std::cout << "Cache TTL set to: " << tokens[1] << " ms" << std::endl;
+                    LOG_INFO("Set cache TTL to: " + tokens[1] + " ms");
+                }
+                else if (cmd == "set-cache-revalidate") {
+                    if (tokens.size() < 2 || tokens.size() > 3 || (tokens[1] != "ON" && tokens[1] != "OFF")) {
+                        std::cout << "Usage: set-cache-revalidate <mode> [interval_ms]  # ON, OFF" << std::endl;
+                        continue;
+                    }
+                    auto settings = fs->getCacheValidation();
+                    settings.revalidate = tokens[1] == "ON";
+                    if (tokens.size() == 3) {
+                        settings.revalidateInterval = std::chrono::milliseconds(std::stoll(tokens[2]));
+                    }
+                    fs->setCacheValidation(settings);
+                    std::cout << "Cache revalidation: " << tokens[1];
+                    if (settings.revalidate) {
+                        std::cout << " (every " << settings.revalidateInterval.count() << " ms)";
+                    }
+                    std::cout << std::endl;
+                    LOG_INFO("Set cache revalidation to: " + tokens[1]);
+                }
+                else if (cmd == "set-cache-spill") {
+                    if (tokens.size() != 2) {
+                        std::cout << "Usage: set-cache-spill <bytes>  # 0 disables" << std::endl;
+                        continue;
+                    }
+                    size_t spillBytes = std::stoull(tokens[1]);
+                    fs->setCacheSpill(spillBytes);
+                    std::cout << "Cache spill tier set to: " << spillBytes << " bytes" << std::endl;
+                    LOG_INFO("Set cache spill tier to: " + tokens[1] + " bytes");
+                }
+                else if (cmd == "set-cache-compression") {
+                    if (tokens.size() != 2) {
+                        std::cout << "Usage: set-cache-compression <percent>  # 0 disables" << std::endl;
+                        continue;
+                    }
+                    int percent = std::stoi(tokens[1]);
+                    fs->setCacheCompression(percent / 100.0);
+                    std::cout << "Cache compression set to: " << percent << "% of the budget" << std::endl;
+                    LOG_INFO("Set cache compression to: " + tokens[1] + "%");
+                }
+                else if (cmd == "set-cache-autotune") {
+                    if (tokens.size() != 2 || (tokens[1] != "ON" && tokens[1] != "OFF")) {
+                        std::cout << "Usage: set-cache-autotune <mode>  # ON, OFF" << std::endl;
+                        continue;
+                    }
+                    fs->setCacheAutoTuning(tokens[1] == "ON");
+                    std::cout << "Cache auto-tuning: " << tokens[1] << std::endl;
+                    LOG_INFO("Set cache auto-tuning to: " + tokens[1]);
                 }
                 else if (cmd == "cache-analytics") {
                     fs->showCacheAnalytics();
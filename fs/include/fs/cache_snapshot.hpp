@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include "cache/enhanced_cache.hpp"
+#include "threading/thread_pool.hpp"
+
+namespace mtfs::fs {
+
+struct WarmStartStats {
+    size_t snapshotsWritten{0};
+    size_t lastSnapshotEntries{0};  // Keys in the most recent snapshot
+    size_t restoreQueued{0};        // Keys read back from the snapshot at mount
+    size_t restored{0};             // Files loaded back into the cache
+    size_t skipped{0};              // Files gone, already cached or changed meanwhile
+    double lastRestoreMs{0.0};      // Wall time of the last completed reload
+    bool restoring{false};
+};
+
+// Persists the hot key set of the file cache (keys, access counts and pins,
+// no file contents) and rebuilds the cache from it after a restart.
+// Reloading reads the files back from disk on a worker pool, hottest keys
+// first, so the hit rate recovers while the file system is already serving.
+// The file is written to a temporary name and renamed into place, so a
+// crash mid-write leaves the previous snapshot intact.
+class CacheSnapshot {
+public:
+    using Entry = cache::KeySnapshot<std::string>;
+
+    struct Hooks {
+        // Keys to persist, hottest first
+        std::function<std::vector<Entry>()> capture;
+        // Load one batch back into the cache; returns how many were restored
+        std::function<size_t(const std::vector<Entry>&)> restore;
+    };
+
+    CacheSnapshot(std::string snapshotPath, Hooks hooks);
+    ~CacheSnapshot();
+
+    CacheSnapshot(const CacheSnapshot&) = delete;
+    CacheSnapshot& operator=(const CacheSnapshot&) = delete;
+
+    // Write the current hot set; false if the file could not be written
+    bool save();
+    // Start reloading the last snapshot in the background; false when there
+    // is no snapshot or a reload is already running
+    bool restoreAsync(size_t threads);
+    void waitForRestore();
+    // Stop handing out further batches of a running reload
+    void cancelRestore();
+
+    // Save every interval on a background thread until stopPeriodic()
+    void startPeriodic(std::chrono::seconds interval);
+    void stopPeriodic();
+
+    WarmStartStats getStats() const;
+
+    // On-disk format, exposed for tools and tests
+    static bool writeFile(const std::string& path, const std::vector<Entry>& entries);
+    static std::vector<Entry> readFile(const std::string& path);
+
+private:
+    static constexpr size_t RESTORE_BATCH = 32;  // Files per worker task
+
+    void restoreBatch(std::vector<Entry> batch);
+    void finishBatch();
+
+    const std::string snapshotPath;
+    Hooks hooks;
+    WarmStartStats stats;
+    size_t pendingBatches{0};
+    bool cancelled{false};
+    std::chrono::steady_clock::time_point restoreStart;
+    mutable std::mutex snapshotMutex;
+    std::mutex saveMutex;  // Serializes writers of the snapshot file
+    std::condition_variable restoreDone;
+    std::unique_ptr<threading::ThreadPool> restorePool;
+
+    std::thread periodicThread;
+    bool stopRequested{false};
+    std::condition_variable periodicWake;
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace mtfs::fs {
+
+// How long a cached file may be served without looking at the disk
+struct ValidationSettings {
+    std::chrono::milliseconds ttl{0};                    // Maximum age of a cached copy, 0 = unlimited
+    bool revalidate{false};                              // Compare mtime and size on cache hits
+    std::chrono::milliseconds revalidateInterval{1000};  // Minimum time between checks of one file
+};
+
+struct ValidationStats {
+    size_t expired{0};        // Hits refused because the copy outlived the TTL
+    size_t revalidations{0};  // Hits that looked at the file on disk
+    size_t stale{0};          // Revalidations that could not confirm the copy
+};
+
+// Decides whether a cached copy of a file may still be served when other
+// processes write into the root behind our back. Each load records the
+// file's modification time and size, taken before the bytes are read, so
+// a write racing with the read shows up as a newer stamp. A hit is refused
+// once the copy is older than the TTL; with revalidation on, the file is
+// stat'ed at most once per interval and the hit is refused if the stamp
+// moved. mtimes may only have one-second resolution, so a copy of a file
+// modified in the same second it was loaded is never confirmed by its
+// stamp and is reloaded at its next check instead.
+// Copies cached while validation was off carry no stamp and are reloaded
+// at their first hit. With both checks off a hit costs one atomic load.
+class CacheValidator {
+public:
+    CacheValidator(std::string rootPath, std::function<bool(const std::string&)> isCached);
+
+    CacheValidator(const CacheValidator&) = delete;
+    CacheValidator& operator=(const CacheValidator&) = delete;
+
+    void configure(const ValidationSettings& settings);
+    ValidationSettings getSettings() const;
+
+    // Stamp a copy about to enter the cache; call before reading the file
+    void record(const std::string& path);
+    // Whether the cached copy of path may be served
+    bool check(const std::string& path);
+    void forget(const std::string& path);
+    void forgetIf(const std::function<bool(const std::string&)>& predicate);
+    void clear();
+
+    ValidationStats getStats() const;
+    void resetStats();
+
+private:
+    static constexpr size_t PRUNE_THRESHOLD = 65536;  // Records kept before uncached ones are dropped
+
+    struct Stamp {
+        int64_t modifiedAt{0};  // Seconds since the epoch
+        int64_t size{-1};
+    };
+
+    struct Record {
+        Stamp stamp;
+        int64_t stampedAt{0};  // Wall-clock second the stamp was taken
+        std::chrono::steady_clock::time_point loadedAt;
+        std::chrono::steady_clock::time_point validatedAt;
+    };
+
+    bool stampFile(const std::string& path, Stamp& stamp) const;
+    void prune();
+
+    const std::string rootPath;
+    std::function<bool(const std::string&)> isCached;
+    std::atomic<bool> active{false};
+    ValidationSettings settings;
+    std::unordered_map<std::string, Record> records;
+    size_t pruneAt{PRUNE_THRESHOLD};
+    ValidationStats stats;
+    mutable std::mutex validatorMutex;
+};
+
+} // namespace mtfs::fs
@@ -6,12 +6,19 @@
 #include <cstdint>
 #include <chrono>
 #include <unordered_map>
+#include <atomic>
 #include "common/error.hpp"
 #include "common/auth.hpp"
 #include "cache/lru_cache.h"
 #include "cache/enhanced_cache.hpp"
+#include "cache/epoch.hpp"
+#include "cache/single_flight.hpp"
 #include "fs/compression.hpp"
 #include "fs/backup_manager.hpp"
+#include "fs/page_cache.hpp"
+#include "fs/prefetcher.hpp"
+#include "fs/cache_snapshot.hpp"
+#include "fs/cache_validator.hpp"
 
 namespace mtfs::fs {
 
@@ -32,6 +39,8 @@ struct PerformanceStats {
     size_t totalReads{0};
     size_t totalWrites{0};
     size_t totalFileOperations{0};
+    size_t diskLoads{0};       // Cache misses that read the file from disk
+    size_t coalescedReads{0};  // Cache misses that waited on another thread's load
     double avgReadTime{0.0};
     double avgWriteTime{0.0};
     std::chrono::system_clock::time_point lastResetTime;
@@ -53,6 +62,8 @@ public:
     bool createFile(const std::string& path);
     bool writeFile(const std::string& path, const std::string& data);
     std::string readFile(const std::string& path);
+    // Zero-copy variant: cache hits share the cached buffer instead of copying it
+    cache::SharedBuffer readFileShared(const std::string& path);
     bool deleteFile(const std::string& path);
     
     // Directory operations
@@ -80,18 +91,51 @@ public:
       // Cache control
     void clearCache();
     size_t getCacheSize() const;
+    // Targeted invalidation: drop one file, or everything under a directory
+    void invalidateCachedFile(const std::string& path);
+    void invalidateCachedDirectory(const std::string& directory);
     
     // Enhanced cache management
     void setCachePolicy(cache::CachePolicy policy);
     cache::CachePolicy getCachePolicy() const;
-    void resizeCache(size_t newCapacity);
+    void resizeCache(size_t newCapacityBytes);
+    void setCacheAdmissionPolicy(cache::AdmissionPolicy policy);
     void pinFile(const std::string& path);
     void unpinFile(const std::string& path);
     bool isFilePinned(const std::string& path) const;
+    // Load a file into the cache in the background
     void prefetchFile(const std::string& path);
+    void setPrefetchEnabled(bool enabled);
+    bool isPrefetchEnabled() const;
+    void waitForPrefetches();
+    PrefetchStats getPrefetchStatistics() const;
+    // Warm start: unmount() and a periodic timer persist the hot key set,
+    // mount() reloads it in the background
+    bool saveCacheSnapshot();
+    void waitForCacheWarmup();
+    WarmStartStats getWarmStartStats() const;
+    // Expiry and on-disk revalidation of cached files, for roots that
+    // other processes write to; both are off by default
+    void setCacheValidation(const ValidationSettings& settings);
+    ValidationSettings getCacheValidation() const;
+    ValidationStats getCacheValidationStatistics() const;
+    // Spill evicted files to a scratch file under the root, up to
+    // capacityBytes, and serve later misses from it; 0 turns it off
+    void setCacheSpill(size_t capacityBytes);
+    cache::SpillStatistics getCacheSpillStatistics() const;
+    // Keep compressedShare of the cache budget for evicted files stored
+    // compressed, which suits text; 0 turns it off
+    void setCacheCompression(double compressedShare);
+    cache::CompressionStatistics getCacheCompressionStatistics() const;
+    // Simulate the other cache policies on sampled reads and switch to one
+    // that clearly beats the current policy
+    void setCacheAutoTuning(bool enabled);
+    cache::TuningStatistics getCacheTuningStatistics() const;
     cache::CacheStatistics getCacheStatistics() const;
+    PageCacheStats getPageCacheStatistics() const;
     void resetCacheStatistics();
     void showCacheAnalytics() const;
+    // Most read files, by lookups with older ones decaying
     std::vector<std::string> getHotFiles(size_t count = 10) const;
     
     // Performance monitoring
@@ -113,7 +157,8 @@ public:
     void showBackupDashboard() const;
     BackupStats getBackupStats() const;
     
-    virtual ~FileSystem() = default;
+    // Stops the prefetch and warm-up workers before any member they use
+    virtual ~FileSystem();
 
 protected:
     explicit FileSystem(const std::string& rootPath, mtfs::common::AuthManager* auth = nullptr);
@@ -121,20 +166,69 @@ protected:
 private:
     FileMetadata resolvePath(const std::string& path);
     
+    // Read a whole file from disk, including pending page cache writes
+    cache::SharedBuffer loadFromDisk(const std::string& path);
+    // Prefetcher load hook; false when the file is missing or already cached
+    bool prefetchIntoCache(const std::string& path);
+    // Warm-start restore hook: reload one snapshot batch through warmup()
+    size_t restoreSnapshotBatch(const std::vector<CacheSnapshot::Entry>& batch);
+    
     // Helper function for glob pattern matching
     bool matchesPattern(const std::string& filename, const std::string& pattern);
     
     std::string rootPath;
     
-    // Enhanced cache for file contents
-    static constexpr size_t CACHE_CAPACITY = 1000;
-    std::unique_ptr<cache::CacheManager<std::string, std::string>> enhancedCache;
+    // Enhanced cache for file contents, budgeted in bytes of cached data
+    static constexpr size_t CACHE_CAPACITY_BYTES = 256 * 1024 * 1024;
+    static constexpr size_t CACHE_SHARDS = 16;  // Independent lock/eviction domains
+    std::unique_ptr<cache::CacheManager<std::string, cache::SharedBuffer>> enhancedCache;
+    
+    // Page cache behind the offset-based read()/write(), written back on sync()
+    static constexpr size_t PAGE_CACHE_PAGES = 16384;  // 64 MiB of 4 KiB pages
+    std::unique_ptr<PageCache> pageCache;
+    
+    // Concurrent misses on the same file share one disk read
+    cache::SingleFlight<std::string, cache::SharedBuffer> readFlights;
+    
+    // Bumped on every write or invalidation; a prefetch that raced with
+    // one is dropped instead of caching stale contents
+    std::atomic<uint64_t> cacheGeneration{0};
+    
+    // TTL and mtime/size checks that keep cached copies honest when the
+    // files change underneath us
+    std::unique_ptr<CacheValidator> cacheValidator;
+    
+    // Learns access patterns from readFile and loads likely-next files on
+    // background workers; declared after the caches it fills so that its
+    // workers stop first
+    static constexpr size_t PREFETCH_THREADS = 2;
+    std::unique_ptr<Prefetcher> prefetcher;
+    
+    // Hot key snapshot for warm restarts, kept next to the metadata file
+    static constexpr size_t SNAPSHOT_MAX_KEYS = 65536;
+    static constexpr size_t WARMUP_THREADS = 4;
+    static constexpr std::chrono::seconds SNAPSHOT_INTERVAL{300};
+    std::unique_ptr<CacheSnapshot> cacheSnapshot;
     
-    // Legacy cache for compatibility
+    // Legacy cache for compatibility (entry-count capacity)
+    static constexpr size_t LEGACY_CACHE_CAPACITY = 1000;
     cache::LRUCache<std::string, std::string> fileCache;
     
-    // Performance statistics
-    mutable PerformanceStats stats;
+    // Performance statistics, summed into a PerformanceStats by getStats().
+    // Every reading thread bumps them, so each thread slot gets its own
+    // cache line instead of all cores contending on one counter.
+    struct alignas(64) OperationCounters {
+        std::atomic<size_t> cacheHits{0};
+        std::atomic<size_t> cacheMisses{0};
+        std::atomic<size_t> diskLoads{0};
+        std::atomic<size_t> reads{0};
+        std::atomic<size_t> writes{0};
+        std::atomic<uint64_t> readMicros{0};
+        std::atomic<uint64_t> writeMicros{0};
+    };
+    mutable OperationCounters operationCounters[cache::EpochDomain::SLOTS];
+    std::chrono::system_clock::time_point statsResetTime{std::chrono::system_clock::now()};
+    OperationCounters& localCounters() const { return operationCounters[cache::EpochDomain::slotIndex()]; }
     
     // Compression statistics
     mutable CompressionStats compressionStats;
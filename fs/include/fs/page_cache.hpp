@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <cstddef>
+#include "common/error.hpp"
+
+namespace mtfs::fs {
+
+struct PageCacheStats {
+    size_t hits{0};
+    size_t misses{0};
+    size_t evictions{0};
+    size_t writebacks{0};     // Dirty pages written to disk
+    size_t residentPages{0};
+    size_t dirtyPages{0};
+    size_t trackedFiles{0};   // Files with at least one resident page
+
+    double getHitRate() const {
+        size_t total = hits + misses;
+        return total > 0 ? (static_cast<double>(hits) / total) * 100.0 : 0.0;
+    }
+};
+
+// Write-back cache of fixed-size file pages, keyed by (file, page index),
+// with LRU replacement over all pages. Writes only dirty the cached pages;
+// they reach disk when flushed, when their page is evicted, or when the
+// cache is destroyed. Paths are the on-disk paths used for I/O.
+class PageCache {
+public:
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    explicit PageCache(size_t capacityPages);
+    ~PageCache();
+
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    // Offset-based I/O through the cache; the file must already exist
+    size_t read(const std::string& path, void* buffer, size_t size, size_t offset);
+    size_t write(const std::string& path, const void* buffer, size_t size, size_t offset);
+
+    // Write back dirty pages of one file or of every file
+    void flush(const std::string& path);
+    void flushAll();
+    // Drop every cached page of a file without writing it back, for files
+    // that were deleted or replaced as a whole
+    void discard(const std::string& path);
+
+    PageCacheStats getStats() const;
+    void resetStats();
+
+private:
+    struct Page {
+        std::string path;
+        size_t index;
+        std::vector<char> data;
+        bool dirty{false};
+    };
+    using PageList = std::list<Page>;  // front is most recently used
+
+    struct FileState {
+        size_t size{0};  // Logical size including unflushed writes
+        std::map<size_t, PageList::iterator> pages;
+    };
+
+    FileState& fileState(const std::string& path);
+    PageList::iterator getPage(const std::string& path, FileState& file, size_t index, bool load);
+    // Evicts least recently used pages; never drops the state of inUse
+    void makeRoom(const FileState& inUse);
+    void writeBack(const std::string& path, FileState& file);
+
+    const size_t maxPages;
+    PageList pages;
+    std::unordered_map<std::string, FileState> files;
+    size_t dirtyCount{0};
+    PageCacheStats stats;
+    mutable std::mutex cacheMutex;
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include "threading/thread_pool.hpp"
+
+namespace mtfs::fs {
+
+struct PrefetchStats {
+    size_t issued{0};     // Speculative loads handed to the workers
+    size_t completed{0};  // Loads that put a file into the cache
+    size_t used{0};       // Prefetched files read before leaving the cache
+    size_t wasted{0};     // Prefetched files evicted or invalidated unread
+    size_t throttled{0};  // Predictions dropped by the throttle
+
+    // Share of settled prefetches that were read, in percent
+    double getAccuracy() const {
+        size_t settled = used + wasted;
+        return settled > 0 ? (static_cast<double>(used) / settled) * 100.0 : 0.0;
+    }
+};
+
+// Background prefetch engine. It watches the stream of whole-file reads,
+// learns per-directory patterns and loads the files it expects to be read
+// next on a small worker pool:
+//   - sequential: "part_07.dat" then "part_08.dat" predicts the files that
+//     continue the numbering with the same stride
+//   - directory locality: reads of several distinct files in one directory
+//     pull in their siblings
+// Every prefetched file is tracked until it is read (used) or has left the
+// cache unread (wasted). Under memory pressure the engine stops scanning
+// directories, shortens its lookahead and, once enough prefetches have
+// settled, stops speculating entirely while its accuracy is poor.
+// The engine only sees paths; all file system and cache access goes
+// through the hooks.
+class Prefetcher {
+public:
+    struct Hooks {
+        // Whether the file is already resident in the cache
+        std::function<bool(const std::string&)> isCached;
+        // Load the file into the cache; false when it does not exist
+        std::function<bool(const std::string&)> load;
+        // Names of the regular files in a directory ("" is the root)
+        std::function<std::vector<std::string>(const std::string&)> listFiles;
+        // Fraction of the cache budget in use, 0.0 - 1.0
+        std::function<double()> cacheOccupancy;
+    };
+
+    Prefetcher(Hooks hooks, size_t workerThreads);
+    ~Prefetcher();
+
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    // Feed one demand read; may schedule speculative loads. Hits are
+    // dropped instead of waiting while another thread holds the engine.
+    void recordAccess(const std::string& path, bool cacheHit);
+    // Explicit hint: load the file in the background, bypassing the
+    // accuracy throttle
+    void enqueue(const std::string& path);
+    // Block until every scheduled load has finished
+    void waitForIdle();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Count outstanding prefetches that have since left the cache as wasted
+    void settle();
+    PrefetchStats getStats() const;
+    void resetStats();
+
+private:
+    static constexpr size_t SEQUENTIAL_DEPTH = 4;         // Files ahead of a sequential reader
+    static constexpr size_t DIRECTORY_FANOUT = 8;         // Siblings loaded per directory scan
+    static constexpr size_t DIRECTORY_RESCAN = 32;        // Reads in a directory between scans
+    static constexpr size_t RECENT_FILES = 4;             // Distinct files remembered per directory
+    static constexpr size_t MAX_DIRECTORIES = 1024;       // Tracked directories before forgetting
+    static constexpr size_t MAX_OUTSTANDING = 4096;       // Unsettled prefetches remembered
+    static constexpr size_t SETTLE_INTERVAL = 64;         // Reads between eviction checks, run on a miss
+    static constexpr size_t SETTLE_BATCH = 256;           // Prefetches checked per settle
+    static constexpr double PRESSURE_WATERMARK = 0.9;     // Cache occupancy that counts as pressure
+    static constexpr size_t MIN_SETTLED = 32;             // Samples before accuracy is trusted
+    static constexpr double MIN_ACCURACY = 50.0;          // Percent; below this, stop under pressure
+
+    struct DirectoryState {
+        // Last numbered file seen: prefix + number + suffix
+        bool hasNumbered{false};
+        std::string prefix;
+        std::string suffix;
+        long long number{0};
+        long long stride{0};
+        std::deque<std::string> recentFiles;
+        size_t readsSinceScan{DIRECTORY_RESCAN};
+    };
+
+    void schedule(const std::string& path, bool speculative, bool pressure);
+    void runLoad(const std::string& path);
+    bool shouldThrottle(bool pressure) const;
+
+    Hooks hooks;
+    bool enabled{true};
+    bool shuttingDown{false};
+    std::unordered_map<std::string, DirectoryState> directories;
+    std::unordered_set<std::string> pending;           // Queued or loading
+    std::deque<std::string> outstandingOrder;          // Loaded, not yet settled
+    std::unordered_set<std::string> outstanding;
+    size_t maxInFlight;
+    size_t readsSinceSettle{0};
+    PrefetchStats stats;
+    mutable std::mutex prefetchMutex;
+    std::condition_variable idle;
+
+    // Declared last so the workers stop before the state they use is gone
+    threading::ThreadPool workers;
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,251 @@
+#include "fs/cache_snapshot.hpp"
+#include "common/logger.hpp"
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+// Layout: magic, version, entry count, then per entry the access count,
+// the pin flag, the key length and the key bytes (host byte order)
+constexpr char SNAPSHOT_MAGIC[8] = {'M', 'T', 'F', 'S', 'S', 'N', 'A', 'P'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+// Longest key accepted on restore; keys are paths, and even extended
+// Windows paths stop at 32767 characters
+constexpr uint32_t MAX_KEY_LENGTH = 32767;
+
+template<typename T>
+void writeValue(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+bool readValue(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // namespace
+
+CacheSnapshot::CacheSnapshot(std::string snapshotPath, Hooks hooks)
+    : snapshotPath(std::move(snapshotPath)), hooks(std::move(hooks)) {}
+
+CacheSnapshot::~CacheSnapshot() {
+    stopPeriodic();
+    cancelRestore();
+    if (restorePool) {
+        restorePool->stop();
+    }
+}
+
+bool CacheSnapshot::save() {
+    std::lock_guard<std::mutex> saveLock(saveMutex);
+    std::vector<Entry> entries = hooks.capture();
+    if (!writeFile(snapshotPath, entries)) {
+        LOG_ERROR("Failed to write cache snapshot: " + snapshotPath);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    stats.snapshotsWritten++;
+    stats.lastSnapshotEntries = entries.size();
+    LOG_INFO("Cache snapshot saved: " + std::to_string(entries.size()) + " keys");
+    return true;
+}
+
+bool CacheSnapshot::restoreAsync(size_t threads) {
+    std::vector<Entry> entries = readFile(snapshotPath);
+    if (entries.empty()) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(snapshotMutex);
+    if (stats.restoring) {
+        return false;
+    }
+    if (!restorePool) {
+        restorePool = std::make_unique<threading::ThreadPool>(std::max<size_t>(1, threads));
+        restorePool->start();
+    }
+    stats.restoring = true;
+    stats.restoreQueued = entries.size();
+    stats.restored = 0;
+    stats.skipped = 0;
+    cancelled = false;
+    restoreStart = std::chrono::steady_clock::now();
+    pendingBatches = (entries.size() + RESTORE_BATCH - 1) / RESTORE_BATCH;
+
+    // Batches are queued hottest first, so the keys that matter most are
+    // back in the cache earliest
+    for (size_t start = 0; start < entries.size(); start += RESTORE_BATCH) {
+        size_t end = std::min(entries.size(), start + RESTORE_BATCH);
+        std::vector<Entry> batch(std::make_move_iterator(entries.begin() + start),
+                                 std::make_move_iterator(entries.begin() + end));
+        restorePool->submit([this, batch = std::move(batch)]() mutable {
+            restoreBatch(std::move(batch));
+        });
+    }
+    LOG_INFO("Cache warm-up started: " + std::to_string(entries.size()) + " keys");
+    return true;
+}
+
+void CacheSnapshot::waitForRestore() {
+    std::unique_lock<std::mutex> lock(snapshotMutex);
+    restoreDone.wait(lock, [this] { return !stats.restoring; });
+}
+
+void CacheSnapshot::cancelRestore() {
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        cancelled = true;
+    }
+    waitForRestore();
+}
+
+void CacheSnapshot::startPeriodic(std::chrono::seconds interval) {
+    stopPeriodic();
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    stopRequested = false;
+    periodicThread = std::thread([this, interval] {
+        std::unique_lock<std::mutex> lock(snapshotMutex);
+        while (!periodicWake.wait_for(lock, interval, [this] { return stopRequested; })) {
+            lock.unlock();
+            try {
+                save();
+            } catch (const std::exception& e) {
+                LOG_ERROR("Periodic cache snapshot failed: " + std::string(e.what()));
+            }
+            lock.lock();
+        }
+    });
+}
+
+void CacheSnapshot::stopPeriodic() {
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        stopRequested = true;
+    }
+    periodicWake.notify_all();
+    if (periodicThread.joinable()) {
+        periodicThread.join();
+    }
+}
+
+WarmStartStats CacheSnapshot::getStats() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return stats;
+}
+
+bool CacheSnapshot::writeFile(const std::string& path, const std::vector<Entry>& entries) {
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        writeValue<uint32_t>(out, SNAPSHOT_VERSION);
+        writeValue<uint32_t>(out, static_cast<uint32_t>(entries.size()));
+        for (const auto& entry : entries) {
+            writeValue<uint32_t>(out, static_cast<uint32_t>(std::min<size_t>(entry.accessCount, UINT32_MAX)));
+            writeValue<uint8_t>(out, entry.isPinned ? 1 : 0);
+            writeValue<uint32_t>(out, static_cast<uint32_t>(entry.key.size()));
+            out.write(entry.key.data(), static_cast<std::streamsize>(entry.key.size()));
+        }
+        if (!out.flush()) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows; elsewhere it
+    // is atomic and the old snapshot stays until the new one takes over
+    std::remove(path.c_str());
+#endif
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+std::vector<CacheSnapshot::Entry> CacheSnapshot::readFile(const std::string& path) {
+    std::vector<Entry> entries;
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return entries;
+    }
+    const std::streamoff fileSize = in.tellg();
+    in.seekg(0);
+
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+        !readValue(in, version) || version != SNAPSHOT_VERSION || !readValue(in, count)) {
+        LOG_ERROR("Ignoring unreadable cache snapshot: " + path);
+        return entries;
+    }
+
+    // A truncated file still yields every complete entry before the cut
+    entries.reserve(std::min<uint32_t>(count, 1 << 20));
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t accessCount = 0;
+        uint8_t pinned = 0;
+        uint32_t keyLength = 0;
+        if (!readValue(in, accessCount) || !readValue(in, pinned) || !readValue(in, keyLength)) {
+            break;
+        }
+        // A corrupt length must not turn into a huge allocation
+        if (keyLength > MAX_KEY_LENGTH || keyLength > fileSize - in.tellg()) {
+            LOG_ERROR("Ignoring corrupt cache snapshot entry in " + path);
+            break;
+        }
+        Entry entry;
+        entry.key.resize(keyLength);
+        if (!in.read(&entry.key[0], keyLength)) {
+            break;
+        }
+        entry.accessCount = accessCount;
+        entry.isPinned = pinned != 0;
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+void CacheSnapshot::restoreBatch(std::vector<Entry> batch) {
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        if (cancelled) {
+            stats.skipped += batch.size();
+            finishBatch();
+            return;
+        }
+    }
+
+    size_t restored = 0;
+    try {
+        restored = hooks.restore(batch);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Cache warm-up batch failed: " + std::string(e.what()));
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    stats.restored += restored;
+    stats.skipped += batch.size() - std::min(restored, batch.size());
+    finishBatch();
+}
+
+void CacheSnapshot::finishBatch() {
+    if (--pendingBatches > 0) {
+        return;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - restoreStart;
+    stats.lastRestoreMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    stats.restoring = false;
+    LOG_INFO("Cache warm-up finished: " + std::to_string(stats.restored) + " files restored");
+    restoreDone.notify_all();
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,149 @@
+#include "fs/cache_validator.hpp"
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <ctime>
+#include <algorithm>
+
+namespace mtfs::fs {
+
+CacheValidator::CacheValidator(std::string rootPath, std::function<bool(const std::string&)> isCached)
+    : rootPath(std::move(rootPath)), isCached(std::move(isCached)) {}
+
+void CacheValidator::configure(const ValidationSettings& settings) {
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    this->settings = settings;
+    bool enable = settings.ttl.count() > 0 || settings.revalidate;
+    if (!enable) {
+        // Stamps stop being maintained, so they cannot be trusted later
+        records.clear();
+    }
+    active.store(enable);
+}
+
+ValidationSettings CacheValidator::getSettings() const {
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    return settings;
+}
+
+void CacheValidator::record(const std::string& path) {
+    if (!active.load(std::memory_order_relaxed)) {
+        return;
+    }
+    Stamp stamp;
+    if (!stampFile(path, stamp)) {
+        return;
+    }
+    Record record;
+    record.stamp = stamp;
+    record.stampedAt = static_cast<int64_t>(std::time(nullptr));
+    record.loadedAt = record.validatedAt = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    records[path] = record;
+    if (records.size() > pruneAt) {
+        prune();
+    }
+}
+
+bool CacheValidator::check(const std::string& path) {
+    if (!active.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    auto now = std::chrono::steady_clock::now();
+    Record recorded;
+    {
+        std::lock_guard<std::mutex> lock(validatorMutex);
+        auto found = records.find(path);
+        if (found == records.end()) {
+            return false;
+        }
+        if (settings.ttl.count() > 0 && now - found->second.loadedAt >= settings.ttl) {
+            stats.expired++;
+            records.erase(found);
+            return false;
+        }
+        if (!settings.revalidate || now - found->second.validatedAt < settings.revalidateInterval) {
+            return true;
+        }
+        stats.revalidations++;
+        recorded = found->second;
+    }
+
+    // Stat without the lock; a concurrent reload replaces the record and
+    // is left alone below
+    Stamp current;
+    bool confirmed = stampFile(path, current) && current.modifiedAt == recorded.stamp.modifiedAt &&
+                     current.size == recorded.stamp.size && current.modifiedAt < recorded.stampedAt;
+
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    auto found = records.find(path);
+    bool sameRecord = found != records.end() && found->second.loadedAt == recorded.loadedAt;
+    if (!confirmed) {
+        stats.stale++;
+        if (sameRecord) {
+            records.erase(found);
+        }
+        return false;
+    }
+    if (sameRecord) {
+        found->second.validatedAt = now;
+    }
+    return true;
+}
+
+void CacheValidator::forget(const std::string& path) {
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    records.erase(path);
+}
+
+void CacheValidator::forgetIf(const std::function<bool(const std::string&)>& predicate) {
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    for (auto it = records.begin(); it != records.end();) {
+        if (predicate(it->first)) {
+            it = records.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CacheValidator::clear() {
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    records.clear();
+    pruneAt = PRUNE_THRESHOLD;
+}
+
+ValidationStats CacheValidator::getStats() const {
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    return stats;
+}
+
+void CacheValidator::resetStats() {
+    std::lock_guard<std::mutex> lock(validatorMutex);
+    stats = ValidationStats();
+}
+
+bool CacheValidator::stampFile(const std::string& path, Stamp& stamp) const {
+    struct stat fileStats;
+    std::string fullPath = rootPath + "/" + path;
+    if (stat(fullPath.c_str(), &fileStats) != 0) {
+        return false;
+    }
+    stamp.modifiedAt = static_cast<int64_t>(fileStats.st_mtime);
+    stamp.size = static_cast<int64_t>(fileStats.st_size);
+    return true;
+}
+
+void CacheValidator::prune() {
+    // Records of files the cache has since evicted are never consulted again
+    for (auto it = records.begin(); it != records.end();) {
+        if (!isCached(it->first)) {
+            it = records.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    pruneAt = std::max(PRUNE_THRESHOLD, records.size() * 2);
+}
+
+} // namespace mtfs::fs
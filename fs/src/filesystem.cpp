@@ -11,20 +11,52 @@
 #include <iomanip>
 #include <iostream>
 #include <cstdio>
+#include <algorithm>
 
 namespace mtfs::fs {
 
 using namespace mtfs::common;  // Add this to use exceptions from common namespace
 
 FileSystem::FileSystem(const std::string& rootPath, mtfs::common::AuthManager* auth)
-    : rootPath(rootPath), fileCache(CACHE_CAPACITY),
-      enhancedCache(std::make_unique<cache::CacheManager<std::string, std::string>>(CACHE_CAPACITY)),
+    : rootPath(rootPath), fileCache(LEGACY_CACHE_CAPACITY),
+      enhancedCache(std::make_unique<cache::CacheManager<std::string, cache::SharedBuffer>>(
+          CACHE_CAPACITY_BYTES, cache::CachePolicy::LRU, CACHE_SHARDS)),
+      pageCache(std::make_unique<PageCache>(PAGE_CACHE_PAGES)),
       authManager(auth),
       metadataFilePath(rootPath + "/.mtfs_metadata") {
     LOG_INFO("Initializing filesystem at: " + rootPath);
     _mkdir(rootPath.c_str());
     loadMetadata();
     
+    Prefetcher::Hooks hooks;
+    hooks.isCached = [this](const std::string& path) { return enhancedCache->contains(path); };
+    hooks.load = [this](const std::string& path) { return prefetchIntoCache(path); };
+    hooks.listFiles = [this](const std::string& directory) {
+        std::vector<std::string> files;
+        for (const auto& name : listDirectory(directory)) {
+            struct stat fileStats;
+            std::string fullPath = this->rootPath + "/" + (directory.empty() ? name : directory + "/" + name);
+            if (stat(fullPath.c_str(), &fileStats) == 0 && (fileStats.st_mode & S_IFMT) == S_IFREG) {
+                files.push_back(name);
+            }
+        }
+        return files;
+    };
+    hooks.cacheOccupancy = [this]() {
+        size_t capacity = enhancedCache->capacity();
+        return capacity > 0 ? static_cast<double>(enhancedCache->getStatistics().residentBytes) / capacity : 1.0;
+    };
+    cacheValidator = std::make_unique<CacheValidator>(
+        rootPath, [this](const std::string& path) { return enhancedCache->contains(path); });
+    prefetcher = std::make_unique<Prefetcher>(std::move(hooks), PREFETCH_THREADS);
+    
+    CacheSnapshot::Hooks snapshotHooks;
+    snapshotHooks.capture = [this]() { return enhancedCache->snapshotHotKeys(SNAPSHOT_MAX_KEYS); };
+    snapshotHooks.restore = [this](const std::vector<CacheSnapshot::Entry>& batch) {
+        return restoreSnapshotBatch(batch);
+    };
+    cacheSnapshot = std::make_unique<CacheSnapshot>(rootPath + "/.mtfs_cache_snapshot", std::move(snapshotHooks));
+    
     // Initialize backup manager
     std::string backupDir = rootPath + "_backups";
     try {
@@ -35,6 +67,13 @@ FileSystem::FileSystem(const std::string& rootPath, mtfs::common::AuthManager* a
     }
 }
 
+FileSystem::~FileSystem() {
+    // Their workers call loadFromDisk(), which uses the validator, the
+    // statistics and the metadata declared after them
+    cacheSnapshot.reset();
+    prefetcher.reset();
+}
+
 std::shared_ptr<FileSystem> FileSystem::create(const std::string& rootPath, mtfs::common::AuthManager* auth) {
     return std::shared_ptr<FileSystem>(new FileSystem(rootPath, auth));
 }
@@ -115,14 +154,19 @@ bool FileSystem::writeFile(const std::string& path, const std::string& data) {
         if (!exists(path)) {
             throw FileNotFoundException(path);
         }
+        // The whole file is replaced, pending page writes are obsolete
+        pageCache->discard(fullPath);
         std::ofstream file(fullPath);
         if (!file) {
             throw FSException("Failed to open file for writing: " + path);
         }
         file << data;
-        enhancedCache->put(path, data);
-        stats.totalWrites++;
-        stats.totalFileOperations++;
+        file.close();
+        // Only once the new contents are on disk: a load that read part of
+        // the old or new file must see the bump and drop what it cached
+        cacheGeneration++;
+        cacheValidator->record(path);
+        enhancedCache->put(path, cache::makeSharedBuffer(data));
 
         // Update metadata
         FileMetadata& meta = fileMetadataMap[path];
@@ -132,8 +176,9 @@ bool FileSystem::writeFile(const std::string& path, const std::string& data) {
         
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        double writeTime = duration.count() / 1000.0; // Convert to milliseconds
-        stats.avgWriteTime = (stats.avgWriteTime * (stats.totalWrites - 1) + writeTime) / stats.totalWrites;
+        auto& counters = localCounters();
+        counters.writes.fetch_add(1, std::memory_order_relaxed);
+        counters.writeMicros.fetch_add(duration.count(), std::memory_order_relaxed);
 
         return true;
     } catch (const std::exception& e) {
@@ -143,6 +188,10 @@ bool FileSystem::writeFile(const std::string& path, const std::string& data) {
 }
 
 std::string FileSystem::readFile(const std::string& path) {
+    return *readFileShared(path);
+}
+
+cache::SharedBuffer FileSystem::readFileShared(const std::string& path) {
     try {
         if (authManager && !authManager->isLoggedIn()) {
             throw FSException("Authentication required to read file");
@@ -156,42 +205,61 @@ std::string FileSystem::readFile(const std::string& path) {
             }
         }        // Try to get from cache first
         auto startTime = std::chrono::high_resolution_clock::now();
-        try {
-            std::string cachedData = enhancedCache->get(path);
-            LOG_DEBUG("Cache hit for file: " + path);
-            stats.cacheHits++;
-            stats.totalReads++;
-            stats.totalFileOperations++;
-            
+        auto cachedData = enhancedCache->tryGet(path);
+        if (cachedData && !cacheValidator->check(path)) {
+            // Expired, or changed on disk by someone else
+            LOG_DEBUG("Dropping stale cached copy of file: " + path);
+            cacheGeneration++;
+            enhancedCache->remove(path);
+            cachedData.reset();
+        }
+        auto& counters = localCounters();
+        if (cachedData) {
+            // No logging here: hits are the hot path and the logger
+            // serializes every thread on std::cout
             auto endTime = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-            double readTime = duration.count() / 1000.0; // Convert to milliseconds
-            stats.avgReadTime = (stats.avgReadTime * (stats.totalReads - 1) + readTime) / stats.totalReads;
+            counters.cacheHits.fetch_add(1, std::memory_order_relaxed);
+            counters.reads.fetch_add(1, std::memory_order_relaxed);
+            counters.readMicros.fetch_add(duration.count(), std::memory_order_relaxed);
             
-            return cachedData;
-        } catch (const std::runtime_error&) {
-            // Cache miss, continue to read from disk
+            prefetcher->recordAccess(path, true);
+            return *cachedData;
         }
+        // Cache miss, continue to read from disk
         LOG_DEBUG("Cache miss for file: " + path);
-        stats.cacheMisses++;
-        stats.totalReads++;
-        stats.totalFileOperations++;
+        counters.cacheMisses.fetch_add(1, std::memory_order_relaxed);
         std::string fullPath = rootPath + "/" + path;
         if (!exists(path)) {
             throw FileNotFoundException(path);
         }
-        std::ifstream file(fullPath);
-        if (!file) {
-            throw FSException("Failed to open file for reading: " + path);
-        }        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string data = buffer.str();
-        enhancedCache->put(path, data);
+        bool shared = false;
+        cache::SharedBuffer data = readFlights.run(path, [&]() {
+            // A flight that finished between our miss and run() has already
+            // cached the file
+            if (auto cached = enhancedCache->tryGet(path)) {
+                return *cached;
+            }
+            uint64_t generation = cacheGeneration.load();
+            counters.diskLoads.fetch_add(1, std::memory_order_relaxed);
+            cache::SharedBuffer loaded = loadFromDisk(path);
+            enhancedCache->put(path, loaded);
+            // Same rule as prefetching: a write during the load wins, and
+            // the stale copy it may have overwritten is dropped
+            if (cacheGeneration.load() != generation) {
+                enhancedCache->remove(path);
+            }
+            return loaded;
+        }, &shared);
+        if (shared) {
+            LOG_DEBUG("Joined in-flight load for file: " + path);
+        }
+        prefetcher->recordAccess(path, false);
         
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        double readTime = duration.count() / 1000.0; // Convert to milliseconds
-        stats.avgReadTime = (stats.avgReadTime * (stats.totalReads - 1) + readTime) / stats.totalReads;
+        counters.reads.fetch_add(1, std::memory_order_relaxed);
+        counters.readMicros.fetch_add(duration.count(), std::memory_order_relaxed);
         
         return data;
     } catch (const std::exception& e) {
@@ -200,6 +268,86 @@ std::string FileSystem::readFile(const std::string& path) {
     }
 }
 
+cache::SharedBuffer FileSystem::loadFromDisk(const std::string& path) {
+    std::string fullPath = rootPath + "/" + path;
+    // Pick up offset writes still sitting in the page cache
+    pageCache->flush(fullPath);
+    // Stamp before reading, so a concurrent write leaves a newer mtime
+    cacheValidator->record(path);
+    std::ifstream file(fullPath);
+    if (!file) {
+        throw FSException("Failed to open file for reading: " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return cache::makeSharedBuffer(buffer.str());
+}
+
+bool FileSystem::prefetchIntoCache(const std::string& path) {
+    if (enhancedCache->contains(path)) {
+        return false;
+    }
+    struct stat fileStats;
+    std::string fullPath = rootPath + "/" + path;
+    if (stat(fullPath.c_str(), &fileStats) != 0 || (fileStats.st_mode & S_IFMT) != S_IFREG) {
+        return false;
+    }
+    
+    uint64_t generation = cacheGeneration.load();
+    readFlights.run(path, [&]() {
+        cache::SharedBuffer loaded = loadFromDisk(path);
+        enhancedCache->prefetch(path, loaded);
+        return loaded;
+    });
+    // A write or invalidation since the read started may have been
+    // overwritten by the stale copy; dropping it only costs a miss
+    if (cacheGeneration.load() != generation) {
+        enhancedCache->remove(path);
+        return false;
+    }
+    return true;
+}
+
+size_t FileSystem::restoreSnapshotBatch(const std::vector<CacheSnapshot::Entry>& batch) {
+    uint64_t generation = cacheGeneration.load();
+    std::vector<cache::CacheEntry<std::string, cache::SharedBuffer>> entries;
+    entries.reserve(batch.size());
+    for (const auto& key : batch) {
+        struct stat fileStats;
+        std::string fullPath = rootPath + "/" + key.key;
+        if (enhancedCache->contains(key.key) || stat(fullPath.c_str(), &fileStats) != 0 ||
+            (fileStats.st_mode & S_IFMT) != S_IFREG) {
+            continue;
+        }
+        try {
+            cache::CacheEntry<std::string, cache::SharedBuffer> entry(key.key, loadFromDisk(key.key));
+            entry.accessCount = key.accessCount;
+            entry.isPinned = key.isPinned;
+            entries.push_back(std::move(entry));
+        } catch (const std::exception& e) {
+            LOG_DEBUG("Skipping snapshot entry " + key.key + ": " + e.what());
+        }
+    }
+    
+    std::vector<std::string> keys;
+    keys.reserve(entries.size());
+    for (const auto& entry : entries) {
+        keys.push_back(entry.key);
+    }
+    // Replay coldest first so recency-ordered policies keep the hottest
+    // keys of the batch at the front
+    std::reverse(entries.begin(), entries.end());
+    enhancedCache->warmup(std::move(entries));
+    // Same rule as prefetching: a write during the reload wins
+    if (cacheGeneration.load() != generation) {
+        for (const auto& key : keys) {
+            enhancedCache->remove(key);
+        }
+        return 0;
+    }
+    return keys.size();
+}
+
 bool FileSystem::deleteFile(const std::string& path) {
     try {
         if (authManager && !authManager->isLoggedIn()) {
@@ -216,8 +364,9 @@ bool FileSystem::deleteFile(const std::string& path) {
         if (!exists(path)) {
             throw FileNotFoundException(path);
         }
-        enhancedCache->clear();
-        fileCache.clear();
+        invalidateCachedFile(path);
+        enhancedCache->forgetHotKey(path);
+        pageCache->discard(fullPath);
         fileMetadataMap.erase(path);
         saveMetadata();
         return remove(fullPath.c_str()) == 0;
@@ -270,7 +419,10 @@ FileMetadata FileSystem::getMetadata(const std::string& path) {
         std::string fullPath = rootPath + "/" + path;
         if (!exists(path)) {
             throw FileNotFoundException(path);
-        }        struct stat fileStats;
+        }
+        // Report the size including offset writes not yet on disk
+        pageCache->flush(fullPath);
+        struct stat fileStats;
         if (stat(fullPath.c_str(), &fileStats) != 0) {
             throw FSException("Failed to get file stats: " + path);
         }
@@ -321,18 +473,23 @@ bool FileSystem::exists(const std::string& path) {
 }
 
 void FileSystem::sync() {
-    // In a real implementation, this would flush all buffers to disk
     LOG_INFO("Syncing filesystem");
+    pageCache->flushAll();
 }
 
 void FileSystem::mount() {
     LOG_INFO("Mounting filesystem at: " + rootPath);
     _mkdir(rootPath.c_str());
+    cacheSnapshot->restoreAsync(WARMUP_THREADS);
+    cacheSnapshot->startPeriodic(SNAPSHOT_INTERVAL);
 }
 
 void FileSystem::unmount() {
     LOG_INFO("Unmounting filesystem from: " + rootPath);
     sync();
+    cacheSnapshot->stopPeriodic();
+    cacheSnapshot->cancelRestore();
+    cacheSnapshot->save();
 }
 
 std::size_t FileSystem::write(const std::string& path, const void* buffer, std::size_t size, std::size_t offset) {
@@ -342,14 +499,11 @@ std::size_t FileSystem::write(const std::string& path, const void* buffer, std::
             throw FileNotFoundException(path);
         }
 
-        std::fstream file(fullPath, std::ios::binary | std::ios::in | std::ios::out);
-        if (!file) {
-            throw FSException("Failed to open file for writing: " + path);
-        }
-
-        file.seekp(offset);
-        file.write(static_cast<const char*>(buffer), size);
-        return size;
+        // Dirty pages reach disk on sync(), eviction or a whole-file read
+        size_t written = pageCache->write(fullPath, buffer, size, offset);
+        // The cached copy holds the whole file, it is stale now
+        invalidateCachedFile(path);
+        return written;
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error in low-level write: ") + e.what());
         throw;
@@ -363,14 +517,7 @@ std::size_t FileSystem::read(const std::string& path, void* buffer, std::size_t
             throw FileNotFoundException(path);
         }
 
-        std::ifstream file(fullPath, std::ios::binary);
-        if (!file) {
-            throw FSException("Failed to open file for reading: " + path);
-        }
-
-        file.seekg(offset);
-        file.read(static_cast<char*>(buffer), size);
-        return file.gcount();
+        return pageCache->read(fullPath, buffer, size, offset);
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error in low-level read: ") + e.what());
         throw;
@@ -384,7 +531,9 @@ FileMetadata FileSystem::resolvePath(const std::string& path) {
 
 // Cache control methods
 void FileSystem::clearCache() {
+    cacheGeneration++;
     enhancedCache->clear();
+    cacheValidator->clear();
     fileCache.clear(); // Also clear legacy cache for compatibility
     LOG_INFO("File system cache cleared");
 }
@@ -395,6 +544,39 @@ size_t FileSystem::getCacheSize() const {
            fileCache.size();
 }
 
+void FileSystem::invalidateCachedFile(const std::string& path) {
+    cacheGeneration++;
+    enhancedCache->remove(path);
+    cacheValidator->forget(path);
+    fileCache.remove(path);
+    LOG_DEBUG("Cache invalidated for file: " + path);
+}
+
+void FileSystem::invalidateCachedDirectory(const std::string& directory) {
+    std::string prefix = directory;
+    while (!prefix.empty() && (prefix.back() == '/' || prefix.back() == '\\')) {
+        prefix.pop_back();
+    }
+    if (prefix.empty()) {
+        clearCache();
+        return;
+    }
+    cacheGeneration++;
+    
+    // Match the directory itself and anything below it, but not siblings
+    // that merely share the name ("logs" must not drop "logs_old/a.txt")
+    auto underDirectory = [&prefix](const std::string& key) {
+        if (key.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+        return key.size() == prefix.size() || key[prefix.size()] == '/' || key[prefix.size()] == '\\';
+    };
+    size_t removed = enhancedCache->removeIf(underDirectory);
+    cacheValidator->forgetIf(underDirectory);
+    fileCache.removeIf(underDirectory);
+    LOG_DEBUG("Cache invalidated for directory: " + prefix + " (" + std::to_string(removed) + " files)");
+}
+
 // Enhanced cache management methods
 void FileSystem::setCachePolicy(cache::CachePolicy policy) {
     enhancedCache->setPolicy(policy);
@@ -405,16 +587,22 @@ cache::CachePolicy FileSystem::getCachePolicy() const {
     return enhancedCache->getPolicy();
 }
 
-void FileSystem::resizeCache(size_t newCapacity) {
-    enhancedCache->resize(newCapacity);
-    LOG_INFO("Cache resized to: " + std::to_string(newCapacity));
+void FileSystem::resizeCache(size_t newCapacityBytes) {
+    enhancedCache->resize(newCapacityBytes);
+    LOG_INFO("Cache resized to: " + std::to_string(newCapacityBytes) + " bytes");
+}
+
+void FileSystem::setCacheAdmissionPolicy(cache::AdmissionPolicy policy) {
+    enhancedCache->setAdmissionPolicy(policy);
+    LOG_INFO("Cache admission policy changed to: " + std::to_string(static_cast<int>(policy)));
 }
 
 void FileSystem::pinFile(const std::string& path) {
     try {
-        // Ensure file is in cache first
+        // Ensure file is in cache first; readFile populates it on a miss
+        // without going through the exception path
         if (!enhancedCache->contains(path)) {
-            std::string data = readFile(path);
+            readFile(path);
         }
         enhancedCache->pin(path);
         LOG_DEBUG("File pinned in cache: " + path);
@@ -438,20 +626,117 @@ void FileSystem::prefetchFile(const std::string& path) {
             return;
         }
         
-        std::string data = readFile(path);
-        enhancedCache->prefetch(path, data);
-        LOG_DEBUG("File prefetched: " + path);
+        prefetcher->enqueue(path);
+        LOG_DEBUG("File queued for prefetch: " + path);
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to prefetch file: " + std::string(e.what()));
     }
 }
 
+void FileSystem::setPrefetchEnabled(bool enabled) {
+    prefetcher->setEnabled(enabled);
+    LOG_INFO(std::string("Pattern prefetching ") + (enabled ? "enabled" : "disabled"));
+}
+
+bool FileSystem::isPrefetchEnabled() const {
+    return prefetcher->isEnabled();
+}
+
+void FileSystem::waitForPrefetches() {
+    prefetcher->waitForIdle();
+}
+
+bool FileSystem::saveCacheSnapshot() {
+    return cacheSnapshot->save();
+}
+
+void FileSystem::waitForCacheWarmup() {
+    cacheSnapshot->waitForRestore();
+}
+
+WarmStartStats FileSystem::getWarmStartStats() const {
+    return cacheSnapshot->getStats();
+}
+
+void FileSystem::setCacheValidation(const ValidationSettings& settings) {
+    cacheValidator->configure(settings);
+    LOG_INFO("Cache validation: TTL " + std::to_string(settings.ttl.count()) + " ms, revalidation " +
+             (settings.revalidate ? "every " + std::to_string(settings.revalidateInterval.count()) + " ms"
+                                  : std::string("off")));
+}
+
+ValidationSettings FileSystem::getCacheValidation() const {
+    return cacheValidator->getSettings();
+}
+
+ValidationStats FileSystem::getCacheValidationStatistics() const {
+    return cacheValidator->getStats();
+}
+
+void FileSystem::setCacheSpill(size_t capacityBytes) {
+    if (capacityBytes == 0) {
+        enhancedCache->disableSpillTier();
+        LOG_INFO("Cache spill tier disabled");
+        return;
+    }
+    enhancedCache->enableSpillTier(rootPath + "/.mtfs_cache_spill", capacityBytes);
+    LOG_INFO("Cache spill tier enabled: " + std::to_string(capacityBytes) + " bytes");
+}
+
+cache::SpillStatistics FileSystem::getCacheSpillStatistics() const {
+    return enhancedCache->getSpillStatistics();
+}
+
+void FileSystem::setCacheCompression(double compressedShare) {
+    if (compressedShare <= 0.0) {
+        enhancedCache->disableCompression();
+        LOG_INFO("Cache compression disabled");
+        return;
+    }
+    try {
+        enhancedCache->enableCompression(compressedShare);
+        LOG_INFO("Cache compression enabled for " + std::to_string(static_cast<int>(compressedShare * 100)) +
+                 "% of the cache budget");
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to enable cache compression: " + std::string(e.what()));
+        throw FSException("Invalid compressed share: " + std::string(e.what()));
+    }
+}
+
+cache::CompressionStatistics FileSystem::getCacheCompressionStatistics() const {
+    return enhancedCache->getCompressionStatistics();
+}
+
+void FileSystem::setCacheAutoTuning(bool enabled) {
+    if (enabled) {
+        enhancedCache->enableAutoTuning();
+        LOG_INFO("Cache auto-tuning enabled");
+    } else {
+        enhancedCache->disableAutoTuning();
+        LOG_INFO("Cache auto-tuning disabled");
+    }
+}
+
+cache::TuningStatistics FileSystem::getCacheTuningStatistics() const {
+    return enhancedCache->getTuningStatistics();
+}
+
+PrefetchStats FileSystem::getPrefetchStatistics() const {
+    prefetcher->settle();
+    return prefetcher->getStats();
+}
+
 cache::CacheStatistics FileSystem::getCacheStatistics() const {
     return enhancedCache->getStatistics();
 }
 
+PageCacheStats FileSystem::getPageCacheStatistics() const {
+    return pageCache->getStats();
+}
+
 void FileSystem::resetCacheStatistics() {
     enhancedCache->resetStatistics();
+    cacheValidator->resetStats();
     LOG_INFO("Cache statistics reset");
 }
 
@@ -461,13 +746,14 @@ void FileSystem::showCacheAnalytics() const {
     
     // Get enhanced cache statistics for consistent reporting
     auto cacheStats = enhancedCache->getStatistics();
+    auto stats = getStats();
     std::cout << "File Operations:\n";
-    std::cout << "  Total Reads: " << this->stats.totalReads << "\n";
-    std::cout << "  Total Writes: " << this->stats.totalWrites << "\n";
+    std::cout << "  Total Reads: " << stats.totalReads << "\n";
+    std::cout << "  Total Writes: " << stats.totalWrites << "\n";
     std::cout << "  Enhanced Cache Hit Rate: " << std::fixed << std::setprecision(2) 
               << cacheStats.hitRate << "%\n";
     std::cout << "  Legacy Cache Hit Rate: " << std::fixed << std::setprecision(2) 
-              << this->stats.getCacheHitRate() << "%\n";
+              << stats.getCacheHitRate() << "%\n";
     std::cout << "=============================================\n\n";
 }
 
@@ -485,15 +771,15 @@ bool FileSystem::copyFile(const std::string& source, const std::string& destinat
             throw FileNotFoundException(source);
         }
         
-        // Read source file content
-        std::string content = readFile(source);
+        // Read source file content (shared with the cache, no extra copy)
+        cache::SharedBuffer content = readFileShared(source);
         
         // Create destination file and write content
         if (!createFile(destination)) {
             throw FSException("Failed to create destination file: " + destination);
         }
         
-        if (!writeFile(destination, content)) {
+        if (!writeFile(destination, *content)) {
             throw FSException("Failed to write to destination file: " + destination);
         }
         
@@ -624,16 +910,47 @@ FileMetadata FileSystem::getFileInfo(const std::string& path) {
 
 // Performance monitoring methods
 PerformanceStats FileSystem::getStats() const {
-    return stats;
+    PerformanceStats snapshot;
+    uint64_t readMicros = 0;
+    uint64_t writeMicros = 0;
+    for (const auto& counters : operationCounters) {
+        snapshot.cacheHits += counters.cacheHits.load(std::memory_order_relaxed);
+        snapshot.cacheMisses += counters.cacheMisses.load(std::memory_order_relaxed);
+        snapshot.diskLoads += counters.diskLoads.load(std::memory_order_relaxed);
+        snapshot.totalReads += counters.reads.load(std::memory_order_relaxed);
+        snapshot.totalWrites += counters.writes.load(std::memory_order_relaxed);
+        readMicros += counters.readMicros.load(std::memory_order_relaxed);
+        writeMicros += counters.writeMicros.load(std::memory_order_relaxed);
+    }
+    snapshot.totalFileOperations = snapshot.totalReads + snapshot.totalWrites;
+    // Milliseconds
+    snapshot.avgReadTime = snapshot.totalReads > 0 ? readMicros / 1000.0 / snapshot.totalReads : 0.0;
+    snapshot.avgWriteTime = snapshot.totalWrites > 0 ? writeMicros / 1000.0 / snapshot.totalWrites : 0.0;
+    snapshot.lastResetTime = statsResetTime;
+    snapshot.coalescedReads = readFlights.getCoalesced();
+    return snapshot;
 }
 
 void FileSystem::resetStats() {
-    stats = PerformanceStats();
+    for (auto& counters : operationCounters) {
+        counters.cacheHits = 0;
+        counters.cacheMisses = 0;
+        counters.diskLoads = 0;
+        counters.reads = 0;
+        counters.writes = 0;
+        counters.readMicros = 0;
+        counters.writeMicros = 0;
+    }
+    statsResetTime = std::chrono::system_clock::now();
     enhancedCache->resetStatistics();
+    pageCache->resetStats();
+    readFlights.resetCounters();
+    prefetcher->resetStats();
     LOG_INFO("Performance statistics reset");
 }
 
 void FileSystem::showPerformanceDashboard() const {
+    auto stats = getStats();
     auto now = std::chrono::system_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - stats.lastResetTime);
     
@@ -647,14 +964,93 @@ void FileSystem::showPerformanceDashboard() const {
     std::cout << "  Cache Hits: " << cacheStats.hits << "\n";
     std::cout << "  Cache Misses: " << cacheStats.misses << "\n";
     std::cout << "  Cache Hit Rate: " << std::fixed << std::setprecision(2) << cacheStats.hitRate << "%\n";
-    std::cout << "  Cache Size: " << (cacheStats.hits + cacheStats.misses > 0 ? enhancedCache->getHotKeys(1000).size() : 0) << "/" << CACHE_CAPACITY << "\n";
+    std::cout << "  Cache Size: " << cacheStats.residentBytes << "/" << enhancedCache->capacity() << " bytes\n";
+    std::cout << "  Bytes Evicted: " << cacheStats.bytesEvicted << "\n";
     std::cout << "  Pinned Items: " << cacheStats.pinnedItems << "\n";
     std::cout << "  Prefetched Items: " << cacheStats.prefetchedItems << "\n";
     std::cout << "-----------------------------------------------------------\n";
+    std::cout << "PREFETCH:\n";
+    auto prefetchStats = getPrefetchStatistics();
+    std::cout << "  Pattern Prefetching: " << (prefetcher->isEnabled() ? "enabled" : "disabled") << "\n";
+    std::cout << "  Prefetches Issued: " << prefetchStats.issued << "\n";
+    std::cout << "  Prefetches Completed: " << prefetchStats.completed << "\n";
+    std::cout << "  Used / Wasted: " << prefetchStats.used << " / " << prefetchStats.wasted << "\n";
+    std::cout << "  Prefetch Accuracy: " << std::fixed << std::setprecision(2) << prefetchStats.getAccuracy() << "%\n";
+    std::cout << "  Throttled: " << prefetchStats.throttled << "\n";
+    std::cout << "-----------------------------------------------------------\n";
+    std::cout << "WARM START:\n";
+    auto warmStats = cacheSnapshot->getStats();
+    std::cout << "  Snapshots Written: " << warmStats.snapshotsWritten
+              << " (last " << warmStats.lastSnapshotEntries << " keys)\n";
+    std::cout << "  Restored on Mount: " << warmStats.restored << "/" << warmStats.restoreQueued
+              << (warmStats.restoring ? " (in progress)" : "") << "\n";
+    std::cout << "  Warm-up Time: " << std::fixed << std::setprecision(3) << warmStats.lastRestoreMs << " ms\n";
+    std::cout << "-----------------------------------------------------------\n";
+    std::cout << "VALIDATION:\n";
+    auto validation = cacheValidator->getSettings();
+    auto validationStats = cacheValidator->getStats();
+    std::cout << "  TTL: " << (validation.ttl.count() > 0 ? std::to_string(validation.ttl.count()) + " ms" : "off") << "\n";
+    std::cout << "  Revalidation: "
+              << (validation.revalidate ? "every " + std::to_string(validation.revalidateInterval.count()) + " ms" : "off") << "\n";
+    std::cout << "  Expired / Stale: " << validationStats.expired << " / " << validationStats.stale << "\n";
+    std::cout << "  Revalidations: " << validationStats.revalidations << "\n";
+    std::cout << "-----------------------------------------------------------\n";
+    std::cout << "COMPRESSION:\n";
+    if (enhancedCache->hasCompression()) {
+        auto compression = enhancedCache->getCompressionStatistics();
+        std::cout << "  Compressed Hits: " << compression.hits << "\n";
+        std::cout << "  Compressed Entries: " << compression.residentEntries << " ("
+                  << compression.residentBytes << " bytes holding " << compression.rawBytes << ")\n";
+        std::cout << "  Compression Ratio: " << std::fixed << std::setprecision(2) << compression.compressionRatio << "\n";
+        std::cout << "  CPU Compress / Decompress: " << std::setprecision(3) << compression.compressNanos / 1000000.0
+                  << " / " << compression.decompressNanos / 1000000.0 << " ms\n";
+        std::cout << "  Incompressible: " << compression.incompressible << "\n";
+    } else {
+        std::cout << "  Compression: disabled\n";
+    }
+    std::cout << "-----------------------------------------------------------\n";
+    std::cout << "SPILL TIER:\n";
+    if (enhancedCache->hasSpillTier()) {
+        auto spillStats = enhancedCache->getSpillStatistics();
+        std::cout << "  Spill Hits: " << spillStats.hits << "\n";
+        std::cout << "  Spill Misses: " << spillStats.misses << "\n";
+        std::cout << "  Spill Hit Rate: " << std::fixed << std::setprecision(2) << spillStats.hitRate << "%\n";
+        std::cout << "  Spilled / Dropped: " << spillStats.spilled << " / " << spillStats.dropped << "\n";
+        std::cout << "  Spill Size: " << spillStats.residentBytes << " live, " << spillStats.fileBytes << " on disk\n";
+        std::cout << "  Compactions: " << spillStats.compactions << "\n";
+    } else {
+        std::cout << "  Spill Tier: disabled\n";
+    }
+    std::cout << "-----------------------------------------------------------\n";
+    std::cout << "AUTO-TUNING:\n";
+    if (enhancedCache->hasAutoTuning()) {
+        auto tuning = enhancedCache->getTuningStatistics();
+        std::cout << "  Live Policy: " << cache::policyName(tuning.livePolicy) << "\n";
+        std::cout << "  Windows / Switches: " << tuning.evaluations << " / " << tuning.switches << "\n";
+        std::cout << "  Sampling: 1 in " << tuning.sampleRate << " files\n";
+        for (const auto& estimate : tuning.estimates) {
+            std::cout << "  Shadow " << cache::policyName(estimate.policy) << " Hit Rate: " << std::fixed
+                      << std::setprecision(2) << estimate.hitRate << "%\n";
+        }
+    } else {
+        std::cout << "  Auto-Tuning: disabled\n";
+    }
+    std::cout << "-----------------------------------------------------------\n";
+    std::cout << "PAGE CACHE:\n";
+    auto pageStats = pageCache->getStats();
+    std::cout << "  Page Hits: " << pageStats.hits << "\n";
+    std::cout << "  Page Misses: " << pageStats.misses << "\n";
+    std::cout << "  Page Hit Rate: " << std::fixed << std::setprecision(2) << pageStats.getHitRate() << "%\n";
+    std::cout << "  Resident Pages: " << pageStats.residentPages << "/" << PAGE_CACHE_PAGES << "\n";
+    std::cout << "  Dirty Pages: " << pageStats.dirtyPages << "\n";
+    std::cout << "  Pages Written Back: " << pageStats.writebacks << "\n";
+    std::cout << "-----------------------------------------------------------\n";
     std::cout << "FILE OPERATIONS:\n";
     std::cout << "  Total Reads: " << stats.totalReads << "\n";
     std::cout << "  Total Writes: " << stats.totalWrites << "\n";
     std::cout << "  Total File Operations: " << stats.totalFileOperations << "\n";
+    std::cout << "  Disk Loads on Miss: " << stats.diskLoads << "\n";
+    std::cout << "  Coalesced Misses: " << readFlights.getCoalesced() << "\n";
     std::cout << "  Average Read Time: " << std::fixed << std::setprecision(3) << stats.avgReadTime << " ms\n";
     std::cout << "  Average Write Time: " << std::fixed << std::setprecision(3) << stats.avgWriteTime << " ms\n";
     std::cout << "==========================================================\n\n";
@@ -671,6 +1067,7 @@ bool FileSystem::compressFile(const std::string& filePath) {
         
         std::string fullPath = rootPath + "/" + filePath;
         std::string compressedPath = fullPath + ".mtfs";
+        pageCache->flush(fullPath);
         
         // Read original file size
         std::ifstream file(fullPath, std::ios::binary | std::ios::ate);
@@ -693,6 +1090,8 @@ bool FileSystem::compressFile(const std::string& filePath) {
         // Remove original file and rename compressed file
         std::remove(fullPath.c_str());
         std::rename(compressedPath.c_str(), fullPath.c_str());
+        pageCache->discard(fullPath);
+        invalidateCachedFile(filePath);
         
         double ratio = FileCompression::calculateCompressionRatio(originalSize, compressedSize);
         LOG_INFO("File compressed successfully. Compression ratio: " + std::to_string(ratio) + "%");
@@ -713,6 +1112,7 @@ bool FileSystem::decompressFile(const std::string& filePath) {
         }
         
         std::string fullPath = rootPath + "/" + filePath;
+        pageCache->flush(fullPath);
         
         // Check if file is actually compressed
         if (!FileCompression::isCompressed(fullPath)) {
@@ -729,6 +1129,8 @@ bool FileSystem::decompressFile(const std::string& filePath) {
         // Replace original with decompressed
         std::remove(fullPath.c_str());
         std::rename(tempPath.c_str(), fullPath.c_str());
+        pageCache->discard(fullPath);
+        invalidateCachedFile(filePath);
         
         LOG_INFO("File decompressed successfully: " + filePath);
         return true;
@@ -755,6 +1157,7 @@ bool FileSystem::createBackup(const std::string& backupName) {
         }
         
         LOG_INFO("Creating backup: " + backupName);
+        pageCache->flushAll();
         return backupManager->createBackup(backupName, rootPath);
     } catch (const std::exception& e) {
         LOG_ERROR("Error creating backup: " + std::string(e.what()));
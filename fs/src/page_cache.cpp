@@ -0,0 +1,237 @@
+#include "fs/page_cache.hpp"
+#include "common/logger.hpp"
+#include <sys/stat.h>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+PageCache::PageCache(size_t capacityPages) : maxPages(std::max<size_t>(1, capacityPages)) {}
+
+PageCache::~PageCache() {
+    try {
+        flushAll();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to write back page cache: " + std::string(e.what()));
+    }
+}
+
+size_t PageCache::read(const std::string& path, void* buffer, size_t size, size_t offset) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    FileState& file = fileState(path);
+    if (offset >= file.size || size == 0) {
+        if (file.pages.empty()) {
+            files.erase(path);
+        }
+        return 0;
+    }
+
+    size_t total = std::min(size, file.size - offset);
+    char* out = static_cast<char*>(buffer);
+    size_t done = 0;
+    while (done < total) {
+        size_t position = offset + done;
+        size_t index = position / PAGE_SIZE;
+        size_t pageOffset = position % PAGE_SIZE;
+        size_t chunk = std::min(PAGE_SIZE - pageOffset, total - done);
+
+        auto page = getPage(path, file, index, true);
+        std::memcpy(out + done, page->data.data() + pageOffset, chunk);
+        done += chunk;
+    }
+    return total;
+}
+
+size_t PageCache::write(const std::string& path, const void* buffer, size_t size, size_t offset) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    FileState& file = fileState(path);
+
+    // Raise the size first: making room below may write this file back,
+    // and pages past the old end must not be clipped to nothing
+    const size_t diskSize = file.size;
+    file.size = std::max(file.size, offset + size);
+
+    const char* in = static_cast<const char*>(buffer);
+    size_t done = 0;
+    while (done < size) {
+        size_t position = offset + done;
+        size_t index = position / PAGE_SIZE;
+        size_t pageOffset = position % PAGE_SIZE;
+        size_t chunk = std::min(PAGE_SIZE - pageOffset, size - done);
+
+        // A page that is fully overwritten, or lies past the end of the file,
+        // does not need its old contents read from disk
+        size_t pageStart = index * PAGE_SIZE;
+        bool fullPage = pageOffset == 0 && chunk == PAGE_SIZE;
+        bool load = !fullPage && pageStart < diskSize;
+
+        auto page = getPage(path, file, index, load);
+        std::memcpy(page->data.data() + pageOffset, in + done, chunk);
+        if (!page->dirty) {
+            page->dirty = true;
+            dirtyCount++;
+        }
+        done += chunk;
+    }
+    return size;
+}
+
+void PageCache::flush(const std::string& path) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = files.find(path);
+    if (it != files.end()) {
+        writeBack(path, it->second);
+    }
+}
+
+void PageCache::flushAll() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    // One failing file must not keep the others from reaching disk
+    std::exception_ptr failure;
+    for (auto& [path, file] : files) {
+        try {
+            writeBack(path, file);
+        } catch (const std::exception&) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void PageCache::discard(const std::string& path) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = files.find(path);
+    if (it == files.end()) {
+        return;
+    }
+    for (auto& [index, page] : it->second.pages) {
+        if (page->dirty) {
+            dirtyCount--;
+        }
+        pages.erase(page);
+    }
+    files.erase(it);
+}
+
+PageCacheStats PageCache::getStats() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    PageCacheStats snapshot = stats;
+    snapshot.residentPages = pages.size();
+    snapshot.dirtyPages = dirtyCount;
+    snapshot.trackedFiles = files.size();
+    return snapshot;
+}
+
+void PageCache::resetStats() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    stats = PageCacheStats();
+}
+
+PageCache::FileState& PageCache::fileState(const std::string& path) {
+    auto it = files.find(path);
+    if (it != files.end()) {
+        return it->second;
+    }
+
+    // First touch: the on-disk size is the logical size
+    FileState state;
+    struct stat fileStats;
+    if (stat(path.c_str(), &fileStats) == 0) {
+        state.size = static_cast<size_t>(fileStats.st_size);
+    }
+    return files.emplace(path, std::move(state)).first->second;
+}
+
+PageCache::PageList::iterator PageCache::getPage(const std::string& path, FileState& file,
+                                                 size_t index, bool load) {
+    auto found = file.pages.find(index);
+    if (found != file.pages.end()) {
+        stats.hits++;
+        pages.splice(pages.begin(), pages, found->second);
+        return found->second;
+    }
+
+    stats.misses++;
+    // Read before caching anything, so a failed load leaves no zero page behind
+    std::vector<char> data(PAGE_SIZE, 0);
+    if (load) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw FSException("Failed to open file for reading: " + path);
+        }
+        in.seekg(static_cast<std::streamoff>(index * PAGE_SIZE));
+        in.read(data.data(), PAGE_SIZE);
+    }
+
+    makeRoom(file);
+    pages.push_front(Page{path, index, std::move(data), false});
+    auto page = pages.begin();
+    file.pages[index] = page;
+    return page;
+}
+
+void PageCache::makeRoom(const FileState& inUse) {
+    while (pages.size() >= maxPages) {
+        Page& victim = pages.back();
+        auto fileIt = files.find(victim.path);
+        if (victim.dirty) {
+            // Write back the whole file so its dirty pages go out in one pass
+            writeBack(victim.path, fileIt->second);
+        }
+        fileIt->second.pages.erase(victim.index);
+        pages.pop_back();
+        stats.evictions++;
+        // Nothing of the file is cached any more; its size is read again on
+        // the next touch. The caller still holds the state it is filling.
+        if (fileIt->second.pages.empty() && &fileIt->second != &inUse) {
+            files.erase(fileIt);
+        }
+    }
+}
+
+void PageCache::writeBack(const std::string& path, FileState& file) {
+    std::fstream out;
+    std::vector<Page*> written;
+    for (auto& [index, page] : file.pages) {
+        if (!page->dirty) {
+            continue;
+        }
+        if (!out.is_open()) {
+            out.open(path, std::ios::binary | std::ios::in | std::ios::out);
+            if (!out) {
+                throw FSException("Failed to open file for writing: " + path);
+            }
+        }
+
+        // Never write the zero padding beyond the logical end of file
+        size_t pageStart = index * PAGE_SIZE;
+        size_t length = std::min(PAGE_SIZE, file.size - std::min(file.size, pageStart));
+        out.seekp(static_cast<std::streamoff>(pageStart));
+        out.write(page->data.data(), static_cast<std::streamsize>(length));
+        written.push_back(&*page);
+    }
+    if (written.empty()) {
+        return;
+    }
+
+    // Pages stay dirty unless the data provably reached the file
+    out.close();
+    if (!out) {
+        throw FSException("Failed to write back file: " + path);
+    }
+    for (Page* page : written) {
+        page->dirty = false;
+    }
+    dirtyCount -= written.size();
+    stats.writebacks += written.size();
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,328 @@
+#include "fs/prefetcher.hpp"
+#include "common/logger.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+struct NumberedName {
+    std::string prefix;
+    long long number{0};
+    size_t width{0};  // Digits to zero-pad to, 0 when unpadded
+    std::string suffix;
+};
+
+// Split "part_0007.dat" into "part_", 7 and ".dat" around the last digit run
+bool parseNumbered(const std::string& name, NumberedName& out) {
+    size_t end = name.size();
+    while (end > 0 && !std::isdigit(static_cast<unsigned char>(name[end - 1]))) {
+        end--;
+    }
+    if (end == 0) {
+        return false;
+    }
+    size_t start = end;
+    while (start > 0 && std::isdigit(static_cast<unsigned char>(name[start - 1]))) {
+        start--;
+    }
+    size_t digits = end - start;
+    if (digits > 18) {
+        return false;
+    }
+    out.prefix = name.substr(0, start);
+    out.number = std::stoll(name.substr(start, digits));
+    out.width = (digits > 1 && name[start] == '0') ? digits : 0;
+    out.suffix = name.substr(end);
+    return true;
+}
+
+std::string formatNumbered(const std::string& prefix, long long number, size_t width,
+                           const std::string& suffix) {
+    std::string digits = std::to_string(number);
+    if (digits.size() < width) {
+        digits.insert(0, width - digits.size(), '0');
+    }
+    return prefix + digits + suffix;
+}
+
+std::string joinPath(const std::string& directory, const std::string& name) {
+    return directory.empty() ? name : directory + "/" + name;
+}
+
+} // namespace
+
+Prefetcher::Prefetcher(Hooks hooks, size_t workerThreads)
+    : hooks(std::move(hooks)),
+      maxInFlight(std::max<size_t>(1, workerThreads) * 4),
+      workers(std::max<size_t>(1, workerThreads)) {
+    workers.start();
+}
+
+Prefetcher::~Prefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        shuttingDown = true;
+    }
+    // Queued loads see the flag and return without touching the cache
+    workers.stop();
+}
+
+void Prefetcher::recordAccess(const std::string& path, bool cacheHit) {
+    // Hits are on the lock-free read path: one that finds the engine busy
+    // is dropped rather than queued behind it. A miss pays for a disk read
+    // anyway and always waits its turn.
+    std::unique_lock<std::mutex> lock(prefetchMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        if (cacheHit) {
+            return;
+        }
+        lock.lock();
+    }
+
+    auto found = outstanding.find(path);
+    if (found != outstanding.end()) {
+        // A miss on a prefetched file means it was evicted before use
+        outstanding.erase(found);
+        if (cacheHit) {
+            stats.used++;
+        } else {
+            stats.wasted++;
+        }
+    }
+    if (!enabled) {
+        return;
+    }
+    // Probing the cache for evicted prefetches is left to the next miss
+    readsSinceSettle = std::min(readsSinceSettle + 1, SETTLE_INTERVAL);
+    bool settleNow = !cacheHit && readsSinceSettle >= SETTLE_INTERVAL;
+    if (settleNow) {
+        readsSinceSettle = 0;
+    }
+
+    size_t split = path.find_last_of("/\\");
+    std::string directory = split == std::string::npos ? "" : path.substr(0, split);
+    std::string name = split == std::string::npos ? path : path.substr(split + 1);
+    NumberedName numbered;
+    bool isNumbered = parseNumbered(name, numbered);
+    long long stride = 0;
+    bool scan = false;
+    std::unordered_set<std::string> recent;
+
+    if (directories.size() >= MAX_DIRECTORIES && directories.find(directory) == directories.end()) {
+        directories.clear();
+    }
+    DirectoryState& state = directories[directory];
+    state.readsSinceScan++;
+
+    // Sequential: a forward step of one predicts immediately, any other
+    // stride has to repeat before it is trusted
+    if (isNumbered) {
+        if (state.hasNumbered && state.prefix == numbered.prefix && state.suffix == numbered.suffix) {
+            long long step = numbered.number - state.number;
+            if (step != 0 && (step == 1 || step == state.stride)) {
+                stride = step;
+            }
+            state.stride = step;
+        } else {
+            state.stride = 0;
+        }
+        state.hasNumbered = true;
+        state.prefix = numbered.prefix;
+        state.suffix = numbered.suffix;
+        state.number = numbered.number;
+    }
+
+    // Directory locality: several distinct files read from one directory
+    if (std::find(state.recentFiles.begin(), state.recentFiles.end(), name) == state.recentFiles.end()) {
+        state.recentFiles.push_back(name);
+        if (state.recentFiles.size() > RECENT_FILES) {
+            state.recentFiles.pop_front();
+        }
+    }
+    if (stride == 0 && state.recentFiles.size() >= 2 && state.readsSinceScan >= DIRECTORY_RESCAN) {
+        state.readsSinceScan = 0;
+        scan = true;
+        recent.insert(state.recentFiles.begin(), state.recentFiles.end());
+    }
+    lock.unlock();
+
+    if (settleNow) {
+        settle();
+    }
+    if (stride == 0 && !scan) {
+        return;
+    }
+
+    // Under memory pressure only the nearest sequential file is worth a slot
+    bool pressure = hooks.cacheOccupancy() >= PRESSURE_WATERMARK;
+    std::vector<std::string> candidates;
+    if (stride != 0) {
+        size_t depth = pressure ? 1 : SEQUENTIAL_DEPTH;
+        for (size_t i = 1; i <= depth; ++i) {
+            long long next = numbered.number + static_cast<long long>(i) * stride;
+            if (next < 0) {
+                break;
+            }
+            candidates.push_back(joinPath(directory, formatNumbered(numbered.prefix, next, numbered.width, numbered.suffix)));
+        }
+    } else if (!pressure) {
+        try {
+            for (const auto& sibling : hooks.listFiles(directory)) {
+                if (candidates.size() >= DIRECTORY_FANOUT) {
+                    break;
+                }
+                if (sibling.empty() || sibling[0] == '.' || recent.count(sibling)) {
+                    continue;
+                }
+                candidates.push_back(joinPath(directory, sibling));
+            }
+        } catch (const std::exception& e) {
+            LOG_DEBUG("Prefetch directory scan failed: " + std::string(e.what()));
+        }
+    }
+
+    for (const auto& candidate : candidates) {
+        if (!hooks.isCached(candidate)) {
+            schedule(candidate, true, pressure);
+        }
+    }
+}
+
+void Prefetcher::enqueue(const std::string& path) {
+    schedule(path, false, false);
+}
+
+void Prefetcher::waitForIdle() {
+    std::unique_lock<std::mutex> lock(prefetchMutex);
+    idle.wait(lock, [this] { return pending.empty(); });
+}
+
+void Prefetcher::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    this->enabled = enabled;
+    if (!enabled) {
+        directories.clear();
+    }
+}
+
+bool Prefetcher::isEnabled() const {
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    return enabled;
+}
+
+void Prefetcher::settle() {
+    std::vector<std::string> batch;
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        size_t count = std::min(SETTLE_BATCH, outstandingOrder.size());
+        for (size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(outstandingOrder.front()));
+            outstandingOrder.pop_front();
+        }
+    }
+
+    // Probe the cache without holding our lock
+    std::vector<char> resident(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        resident[i] = hooks.isCached(batch[i]);
+    }
+
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto found = outstanding.find(batch[i]);
+        if (found == outstanding.end()) {
+            continue;  // Already read, or settled through another path
+        }
+        if (resident[i]) {
+            outstandingOrder.push_back(std::move(batch[i]));
+        } else {
+            outstanding.erase(found);
+            stats.wasted++;
+        }
+    }
+}
+
+PrefetchStats Prefetcher::getStats() const {
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    return stats;
+}
+
+void Prefetcher::resetStats() {
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    stats = PrefetchStats();
+}
+
+void Prefetcher::schedule(const std::string& path, bool speculative, bool pressure) {
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        if (shuttingDown || pending.count(path) || outstanding.count(path)) {
+            return;
+        }
+        if (speculative && shouldThrottle(pressure)) {
+            stats.throttled++;
+            return;
+        }
+        pending.insert(path);
+        stats.issued++;
+    }
+
+    try {
+        workers.submit([this, path] { runLoad(path); });
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to schedule prefetch: " + std::string(e.what()));
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        pending.erase(path);
+        stats.issued--;
+        idle.notify_all();
+    }
+}
+
+void Prefetcher::runLoad(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        if (shuttingDown) {
+            pending.erase(path);
+            idle.notify_all();
+            return;
+        }
+    }
+
+    bool loaded = false;
+    try {
+        loaded = hooks.load(path);
+    } catch (const std::exception& e) {
+        LOG_DEBUG("Prefetch of " + path + " failed: " + e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    pending.erase(path);
+    if (loaded) {
+        stats.completed++;
+        outstanding.insert(path);
+        outstandingOrder.push_back(path);
+        // Forget the oldest unsettled prefetches rather than grow without bound
+        while (outstandingOrder.size() > MAX_OUTSTANDING) {
+            outstanding.erase(outstandingOrder.front());
+            outstandingOrder.pop_front();
+        }
+    }
+    if (pending.empty()) {
+        idle.notify_all();
+    }
+}
+
+bool Prefetcher::shouldThrottle(bool pressure) const {
+    if (pending.size() >= maxInFlight) {
+        return true;
+    }
+    // Under pressure every prefetch evicts something; only keep going while
+    // prefetches are being read more often than not
+    size_t settled = stats.used + stats.wasted;
+    return pressure && settled >= MIN_SETTLED && stats.getAccuracy() < MIN_ACCURACY;
+}
+
+} // namespace mtfs::fs
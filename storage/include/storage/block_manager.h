@@ -2,56 +2,138 @@
 
 #include <string>
 #include <vector>
-#include <fstream>
 #include <memory>
-#include <windows.h>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
 #include "common/error.hpp"
 
 namespace mtfs::storage {
 
+// Growable block store in a single file, made of segments that each hold
+// an allocation bitmap and then their blocks. Segment 0 is the original
+// fixed layout (a BITMAP_BYTES bitmap and INITIAL_BLOCKS blocks); when it
+// is full the file is extended by a whole segment of SEGMENT_BLOCKS at a
+// time, so block IDs stay stable and a store grows online up to
+// MAX_BLOCKS. The segment count follows from the file size. Free space is
+// found in two levels: per-segment free counts pick a segment, then its
+// bitmap is scanned 64 blocks per word with count-trailing-zeros. Both
+// levels keep a hint below which nothing is free, so allocation skips the
+// full front of the store even when it is almost full.
+//
+// Bitmap changes stay in memory, tracked as a dirty word range per
+// segment, and are written back by checkpoint(): at sync(), on close and
+// every CHECKPOINT_INTERVAL allocations or frees. A checkpoint first
+// writes the dirty ranges to a small redo journal next to the store
+// (storagePath + ".bitmap-journal"), syncs it, then updates the bitmaps in
+// place; opening a store replays a complete journal and drops a torn one.
+// After a crash the bitmaps are therefore exactly as of the last finished
+// checkpoint, never a mix of two.
+//
+// Block I/O uses positional reads and writes on one descriptor (pread/
+// pwrite, or their Windows equivalent), so threads working on different
+// blocks never wait for each other; they share a reader lock that only
+// allocation, freeing, growth and formatting take exclusively.
 class BlockManager {
 public:
     static constexpr size_t BLOCK_SIZE = 4096;  // 4KB blocks
-    static constexpr size_t MAX_BLOCKS = 1024;  // Initial maximum blocks
-    static constexpr size_t BITMAP_BYTES = (MAX_BLOCKS + 7) / 8;  // Size of bitmap in bytes
+    static constexpr size_t INITIAL_BLOCKS = 1024;  // Segment 0, the size of a new store
+    static constexpr size_t BITMAP_BYTES = (INITIAL_BLOCKS + 7) / 8;  // Bitmap of segment 0
+    static constexpr size_t SEGMENT_BLOCKS = 32768;  // Blocks added per growth step (128 MiB)
+    static constexpr size_t SEGMENT_BITMAP_BYTES = SEGMENT_BLOCKS / 8;  // One block
+    static constexpr size_t MAX_BLOCKS = static_cast<size_t>(std::numeric_limits<int>::max());  // IDs are ints
+    static constexpr size_t CHECKPOINT_INTERVAL = 1024;  // Bitmap changes between automatic checkpoints
 
     explicit BlockManager(const std::string& storagePath);
     ~BlockManager();
 
+    BlockManager(const BlockManager&) = delete;
+    BlockManager& operator=(const BlockManager&) = delete;
+
     // Block operations
     bool writeBlock(int blockId, const std::vector<char>& data);
     bool readBlock(int blockId, std::vector<char>& data);
-    int allocateBlock();  // Returns new block ID or -1 on failure
+    int allocateBlock();  // Returns new block ID, growing the store if needed, or -1 on failure
     bool freeBlock(int blockId);
+    // Extents: count contiguous blocks that also lie back to back in the
+    // file, so a large file can be read or written with one I/O. Chosen
+    // best fit over the free runs of a segment; at most SEGMENT_BLOCKS.
+    int allocateBlocks(size_t count);  // Returns the first block ID, or -1 on failure
+    bool freeBlocks(int firstBlock, size_t count);
+    bool writeBlocks(int firstBlock, const std::vector<char>& data);  // Zero-pads the last block
+    bool readBlocks(int firstBlock, size_t count, std::vector<char>& data);
+    // Shrink back to segment 0 with every block free
     void formatStorage();
+    // Write pending bitmap changes back through the journal
+    bool checkpoint();
+    // Checkpoint, then flush written blocks to stable storage
+    bool sync();
 
-    // Utility methods
-    size_t getTotalBlocks() const { return MAX_BLOCKS; }
-    size_t getFreeBlocks();  // Removed const as it modifies critical section
-    bool isBlockFree(int blockId);  // Removed const as it needs to lock
+    // Utility methods; both follow the live size
+    size_t getTotalBlocks() const;
+    size_t getFreeBlocks() const;
+    bool isBlockFree(int blockId) const;
 
 private:
+    struct Segment {
+        size_t firstBlock;
+        size_t blockCount;
+        uint64_t bitmapOffset;
+        uint64_t dataOffset;
+        std::vector<uint64_t> bitmap;  // 1 = used; bit i of word w is block 64 * w + i
+        size_t freeBlocks{0};
+        size_t searchWord{0};  // No free block in the words below this
+        size_t dirtyBegin{0};  // Words [dirtyBegin, dirtyEnd) differ from disk
+        size_t dirtyEnd{0};
+    };
+
+    // A bitmap range captured by a checkpoint
+    struct BitmapRegion {
+        size_t segment;
+        size_t firstWord;
+        uint64_t offset;
+        std::vector<uint8_t> bytes;
+    };
+
     std::string storagePath;
-    std::fstream storageFile;
-    std::vector<uint8_t> blockBitmap;  // 1 = used, 0 = free
-    CRITICAL_SECTION cs;  // Windows critical section for thread safety
+    int fd{-1};
+    std::string journalPath;
+    int journalFd{-1};
+    std::vector<Segment> segments;
+    size_t totalBlocks{0};
+    size_t searchSegment{0};  // No free block in the segments below this
+    size_t changesSinceCheckpoint{0};
+    mutable std::shared_mutex metadataMutex;  // Shared for block I/O, exclusive for bitmap changes
+    std::mutex checkpointMutex;  // Serializes checkpoints and formatting; taken before metadataMutex
 
     // Internal helper methods
     bool initializeStorage();
     void loadBitmap();
-    void saveBitmap();
+    bool replayJournal();
+    bool writeJournal(const std::vector<BitmapRegion>& regions);
+    void markDirty(Segment& segment, size_t word);
+    bool growStorage();
+    void addSegment();
+    static uint64_t segmentEnd(size_t segmentCount);  // File size with that many segments
     bool validateBlockId(int blockId) const;
+    size_t segmentIndex(size_t index) const;
+    Segment& segmentOf(size_t index);
+    const Segment& segmentOf(size_t index) const;
     size_t getBlockOffset(int blockId) const;
+    bool isRangeAllocated(int firstBlock, size_t count) const;
+    size_t contiguousBlocks(size_t index, size_t count) const;  // How many of them follow index in the file
+    size_t findFree(const Segment& segment, size_t local) const;  // Local index, blockCount if none
+    size_t findUsed(const Segment& segment, size_t local) const;
+    size_t findExtent(const Segment& segment, size_t count) const;
     bool setBit(size_t index, bool value);
-    bool getBit(size_t index);  // Removed const as it needs to lock
+    bool getBit(size_t index) const;
 
     // TODO: Future enhancements
     // - Add block compression
     // - Add block encryption
-    // - Add journaling for crash recovery
-    // - Add storage expansion capability
     // - Add block caching
     // - Add defragmentation
 };
 
-} // namespace mtfs::storage 
\ No newline at end of file
+} // namespace mtfs::storage
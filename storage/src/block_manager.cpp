@@ -1,222 +1,817 @@
 #include "storage/block_manager.h"
 #include "common/logger.hpp"
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace mtfs::storage {
 
 using namespace mtfs::common;
 
-BlockManager::BlockManager(const std::string& storagePath) 
-    : storagePath(storagePath), blockBitmap(BITMAP_BYTES, 0) {
-    InitializeCriticalSection(&cs);
+namespace {
+
+// Positional I/O on a descriptor. None of these move a shared file offset,
+// so concurrent calls on different ranges do not interfere.
+
+int openFile(const std::string& path) {
+#ifdef _WIN32
+    return _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+#endif
+}
+
+void closeFile(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+// Reads size bytes at offset; bytes past the end of the file read as zero
+bool readAt(int fd, char* buffer, size_t size, uint64_t offset) {
+    size_t done = 0;
+    while (done < size) {
+#ifdef _WIN32
+        HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset + done);
+        overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+        DWORD transferred = 0;
+        if (!ReadFile(handle, buffer + done, static_cast<DWORD>(size - done), &transferred, &overlapped)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) {
+                transferred = 0;
+            } else {
+                return false;
+            }
+        }
+        long long result = transferred;
+#else
+        ssize_t result = ::pread(fd, buffer + done, size - done, static_cast<off_t>(offset + done));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+#endif
+        if (result == 0) {
+            std::memset(buffer + done, 0, size - done);
+            return true;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool writeAt(int fd, const char* buffer, size_t size, uint64_t offset) {
+    size_t done = 0;
+    while (done < size) {
+#ifdef _WIN32
+        HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset + done);
+        overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+        DWORD transferred = 0;
+        if (!WriteFile(handle, buffer + done, static_cast<DWORD>(size - done), &transferred, &overlapped)) {
+            return false;
+        }
+        done += transferred;
+#else
+        ssize_t result = ::pwrite(fd, buffer + done, size - done, static_cast<off_t>(offset + done));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(result);
+#endif
+    }
+    return true;
+}
+
+bool resizeFile(int fd, uint64_t size) {
+#ifdef _WIN32
+    return _chsize_s(fd, static_cast<long long>(size)) == 0;
+#else
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+uint64_t fileSize(int fd) {
+#ifdef _WIN32
+    struct _stat64 info;
+    return _fstat64(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#else
+    struct stat info;
+    return ::fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#endif
+}
+
+bool syncFile(int fd) {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+// Word-level bitmap helpers. The bitmaps are stored on disk as bytes with
+// block 8 * b + i in bit i of byte b, which is the little-endian layout of
+// the in-memory words; packing them byte by byte keeps the format the same
+// on any host.
+
+static_assert(BlockManager::INITIAL_BLOCKS % 64 == 0 && BlockManager::SEGMENT_BLOCKS % 64 == 0,
+              "segments must fill whole bitmap words");
+
+int countTrailingZeros(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+int popCount(uint64_t word) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+void unpackWords(const std::vector<uint8_t>& bytes, std::vector<uint64_t>& words) {
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint64_t word = 0;
+        for (size_t b = 0; b < 8; ++b) {
+            word |= static_cast<uint64_t>(bytes[w * 8 + b]) << (8 * b);
+        }
+        words[w] = word;
+    }
+}
+
+// Packs words [first, last)
+void packWords(const std::vector<uint64_t>& words, size_t first, size_t last, std::vector<uint8_t>& bytes) {
+    bytes.resize((last - first) * 8);
+    for (size_t w = first; w < last; ++w) {
+        for (size_t b = 0; b < 8; ++b) {
+            bytes[(w - first) * 8 + b] = static_cast<uint8_t>(words[w] >> (8 * b));
+        }
+    }
+}
+
+// Bitmap journal: magic, record count, then per record its file offset,
+// length and bytes, then an FNV-1a checksum of everything before it. All
+// integers are little-endian.
+
+constexpr uint32_t JOURNAL_MAGIC = 0x4A42544D;  // "MTBJ"
+
+void putInt(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+    for (size_t b = 0; b < bytes; ++b) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+    }
+}
+
+bool getInt(const std::vector<uint8_t>& in, size_t& pos, size_t bytes, uint64_t& value) {
+    if (in.size() - pos < bytes) {
+        return false;
+    }
+    value = 0;
+    for (size_t b = 0; b < bytes; ++b) {
+        value |= static_cast<uint64_t>(in[pos++]) << (8 * b);
+    }
+    return true;
+}
+
+uint64_t fnv1a(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+BlockManager::BlockManager(const std::string& storagePath)
+    : storagePath(storagePath), journalPath(storagePath + ".bitmap-journal") {
     if (!initializeStorage()) {
         throw std::runtime_error("Failed to initialize storage");
     }
     loadBitmap();
-    LOG_INFO("Block manager initialized at: " + storagePath);
+    LOG_INFO("Block manager initialized at: " + storagePath + " (" + std::to_string(totalBlocks) + " blocks)");
 }
 
 BlockManager::~BlockManager() {
-    EnterCriticalSection(&cs);
-    saveBitmap();
-    storageFile.close();
-    LeaveCriticalSection(&cs);
-    DeleteCriticalSection(&cs);
+    bool clean = checkpoint();
+    closeFile(journalFd);
+    closeFile(fd);
+    // An empty journal is not needed to reopen the store
+    if (clean) {
+        std::remove(journalPath.c_str());
+    }
 }
 
 bool BlockManager::writeBlock(int blockId, const std::vector<char>& data) {
-    EnterCriticalSection(&cs);
-    try {
-        if (!validateBlockId(blockId) || isBlockFree(blockId)) {
-            LeaveCriticalSection(&cs);
-            LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
-            return false;
+    if (data.size() > BLOCK_SIZE) {
+        LOG_ERROR("Data size exceeds block size");
+        return false;
+    }
+    std::vector<char> blockData(BLOCK_SIZE, 0);
+    std::copy(data.begin(), data.end(), blockData.begin());
+
+    // Shared: writers of other blocks proceed, freeBlock() waits for us
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
+    if (!validateBlockId(blockId) || !getBit(blockId)) {
+        LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
+        return false;
+    }
+    if (!writeAt(fd, blockData.data(), BLOCK_SIZE, getBlockOffset(blockId))) {
+        LOG_ERROR("Failed to write block " + std::to_string(blockId) + ": " + std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool BlockManager::readBlock(int blockId, std::vector<char>& data) {
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
+    if (!validateBlockId(blockId) || !getBit(blockId)) {
+        LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
+        return false;
+    }
+
+    data.resize(BLOCK_SIZE);
+    if (!readAt(fd, data.data(), BLOCK_SIZE, getBlockOffset(blockId))) {
+        LOG_ERROR("Failed to read block " + std::to_string(blockId) + ": " + std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int BlockManager::allocateBlock() {
+    int blockId = -1;
+    bool checkpointDue = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(metadataMutex);
+        // Segments with free blocks are found by count, without touching bitmaps
+        while (searchSegment < segments.size() && segments[searchSegment].freeBlocks == 0) {
+            searchSegment++;
         }
+        if (searchSegment == segments.size() && !growStorage()) {
+            LOG_ERROR("No free blocks available");
+            return -1;
+        }
+
+        Segment& segment = segments[searchSegment];
+        for (size_t w = segment.searchWord; w < segment.bitmap.size(); ++w) {
+            uint64_t freeBits = ~segment.bitmap[w];
+            if (freeBits == 0) {
+                continue;
+            }
+            segment.searchWord = w;
+            size_t index = segment.firstBlock + w * 64 + countTrailingZeros(freeBits);
+            setBit(index, true);
+            blockId = static_cast<int>(index);
+            break;
+        }
+        if (blockId < 0) {
+            LOG_ERROR("Block bitmap and free count disagree");
+            return -1;
+        }
+        checkpointDue = ++changesSinceCheckpoint >= CHECKPOINT_INTERVAL;
+    }
+
+    if (checkpointDue) {
+        checkpoint();
+    }
+    return blockId;
+}
 
-        if (data.size() > BLOCK_SIZE) {
-            LeaveCriticalSection(&cs);
-            LOG_ERROR("Data size exceeds block size");
+bool BlockManager::freeBlock(int blockId) {
+    bool checkpointDue = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(metadataMutex);
+        if (!validateBlockId(blockId) || !getBit(blockId)) {
+            LOG_ERROR("Invalid block ID or block already free: " + std::to_string(blockId));
             return false;
         }
+        setBit(blockId, false);
+        checkpointDue = ++changesSinceCheckpoint >= CHECKPOINT_INTERVAL;
+    }
 
-        std::vector<char> blockData(BLOCK_SIZE, 0);
-        std::copy(data.begin(), data.end(), blockData.begin());
+    if (checkpointDue) {
+        checkpoint();
+    }
+    return true;
+}
 
-        size_t offset = getBlockOffset(blockId);
-        storageFile.seekp(offset);
-        storageFile.write(blockData.data(), BLOCK_SIZE);
-        storageFile.flush();
+int BlockManager::allocateBlocks(size_t count) {
+    if (count == 0 || count > SEGMENT_BLOCKS) {
+        LOG_ERROR("Extent size out of range: " + std::to_string(count));
+        return -1;
+    }
+    int firstBlock = -1;
+    bool checkpointDue = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(metadataMutex);
+        // Best fit within the first segment that has a long enough run;
+        // the free counts rule out most segments without a scan
+        for (size_t i = searchSegment; i < segments.size() && firstBlock < 0; ++i) {
+            const Segment& segment = segments[i];
+            if (segment.freeBlocks < count) {
+                continue;
+            }
+            size_t start = findExtent(segment, count);
+            if (start < segment.blockCount) {
+                firstBlock = static_cast<int>(segment.firstBlock + start);
+            }
+        }
+        if (firstBlock < 0) {
+            if (!growStorage()) {
+                LOG_ERROR("No free extent of " + std::to_string(count) + " blocks");
+                return -1;
+            }
+            firstBlock = static_cast<int>(segments.back().firstBlock);
+        }
 
-        LOG_DEBUG("Written block: " + std::to_string(blockId));
-        LeaveCriticalSection(&cs);
-        return true;
-    } catch (const std::exception& e) {
-        LOG_ERROR("Failed to write block: " + std::string(e.what()));
-        LeaveCriticalSection(&cs);
-        return false;
+        for (size_t i = 0; i < count; ++i) {
+            setBit(firstBlock + i, true);
+        }
+        changesSinceCheckpoint += count;
+        checkpointDue = changesSinceCheckpoint >= CHECKPOINT_INTERVAL;
+    }
+
+    if (checkpointDue) {
+        checkpoint();
     }
+    return firstBlock;
 }
 
-bool BlockManager::readBlock(int blockId, std::vector<char>& data) {
-    EnterCriticalSection(&cs);
-    try {
-        if (!validateBlockId(blockId) || isBlockFree(blockId)) {
-            LeaveCriticalSection(&cs);
-            LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
+bool BlockManager::freeBlocks(int firstBlock, size_t count) {
+    bool checkpointDue = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(metadataMutex);
+        if (!isRangeAllocated(firstBlock, count)) {
+            LOG_ERROR("Invalid extent or part of it already free: " + std::to_string(firstBlock) + "+" +
+                      std::to_string(count));
             return false;
         }
+        for (size_t i = 0; i < count; ++i) {
+            setBit(firstBlock + i, false);
+        }
+        changesSinceCheckpoint += count;
+        checkpointDue = changesSinceCheckpoint >= CHECKPOINT_INTERVAL;
+    }
 
-        data.resize(BLOCK_SIZE);
-        size_t offset = getBlockOffset(blockId);
-        storageFile.seekg(offset);
-        storageFile.read(data.data(), BLOCK_SIZE);
-
-        LOG_DEBUG("Read block: " + std::to_string(blockId));
-        LeaveCriticalSection(&cs);
-        return true;
-    } catch (const std::exception& e) {
-        LOG_ERROR("Failed to read block: " + std::string(e.what()));
-        LeaveCriticalSection(&cs);
-        return false;
+    if (checkpointDue) {
+        checkpoint();
     }
+    return true;
 }
 
-int BlockManager::allocateBlock() {
-    EnterCriticalSection(&cs);
-    for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-        if (!getBit(i)) {
-            setBit(i, true);
-            saveBitmap();
-            LOG_DEBUG("Allocated block: " + std::to_string(i));
-            LeaveCriticalSection(&cs);
-            return static_cast<int>(i);
+bool BlockManager::writeBlocks(int firstBlock, const std::vector<char>& data) {
+    size_t count = (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const char* source = data.data();
+    std::vector<char> padded;
+    if (data.size() != count * BLOCK_SIZE) {
+        padded.assign(count * BLOCK_SIZE, 0);
+        std::copy(data.begin(), data.end(), padded.begin());
+        source = padded.data();
+    }
+
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
+    if (!isRangeAllocated(firstBlock, count)) {
+        LOG_ERROR("Invalid extent or part of it is free: " + std::to_string(firstBlock) + "+" + std::to_string(count));
+        return false;
+    }
+    // One write per segment the range touches, normally just one
+    for (size_t done = 0; done < count;) {
+        size_t index = firstBlock + done;
+        size_t blocks = contiguousBlocks(index, count - done);
+        if (!writeAt(fd, source + done * BLOCK_SIZE, blocks * BLOCK_SIZE, getBlockOffset(static_cast<int>(index)))) {
+            LOG_ERROR("Failed to write blocks at " + std::to_string(index) + ": " + std::strerror(errno));
+            return false;
         }
+        done += blocks;
     }
-    LOG_ERROR("No free blocks available");
-    LeaveCriticalSection(&cs);
-    return -1;
+    return true;
 }
 
-bool BlockManager::freeBlock(int blockId) {
-    EnterCriticalSection(&cs);
-    if (!validateBlockId(blockId) || isBlockFree(blockId)) {
-        LeaveCriticalSection(&cs);
-        LOG_ERROR("Invalid block ID or block already free: " + std::to_string(blockId));
+bool BlockManager::readBlocks(int firstBlock, size_t count, std::vector<char>& data) {
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
+    if (!isRangeAllocated(firstBlock, count)) {
+        LOG_ERROR("Invalid extent or part of it is free: " + std::to_string(firstBlock) + "+" + std::to_string(count));
         return false;
     }
 
-    setBit(blockId, false);
-    saveBitmap();
-    LOG_DEBUG("Freed block: " + std::to_string(blockId));
-    LeaveCriticalSection(&cs);
+    data.resize(count * BLOCK_SIZE);
+    for (size_t done = 0; done < count;) {
+        size_t index = firstBlock + done;
+        size_t blocks = contiguousBlocks(index, count - done);
+        if (!readAt(fd, data.data() + done * BLOCK_SIZE, blocks * BLOCK_SIZE, getBlockOffset(static_cast<int>(index)))) {
+            LOG_ERROR("Failed to read blocks at " + std::to_string(index) + ": " + std::strerror(errno));
+            return false;
+        }
+        done += blocks;
+    }
     return true;
 }
 
 void BlockManager::formatStorage() {
-    EnterCriticalSection(&cs);
-    // Clear bitmap
-    std::fill(blockBitmap.begin(), blockBitmap.end(), 0);
-    
-    // Reset storage file
-    storageFile.close();
-    storageFile.open(storagePath, std::ios::out | std::ios::binary | std::ios::trunc);
-    
-    // Write empty blocks
-    std::vector<char> emptyBlock(BLOCK_SIZE, 0);
-    for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-        storageFile.write(emptyBlock.data(), BLOCK_SIZE);
-    }
-    storageFile.flush();
-    
-    // Reopen in read/write mode
-    storageFile.close();
-    storageFile.open(storagePath, std::ios::in | std::ios::out | std::ios::binary);
-    
-    saveBitmap();
+    std::lock_guard<std::mutex> checkpointLock(checkpointMutex);
+    std::unique_lock<std::shared_mutex> lock(metadataMutex);
+    segments.clear();
+    totalBlocks = 0;
+    searchSegment = 0;
+    changesSinceCheckpoint = 0;
+    addSegment();
+
+    // Truncating first drops the old contents, the blocks and the bitmap
+    // then read as zeros, which is a clean bitmap with nothing to journal
+    if (!resizeFile(fd, 0) || !resizeFile(fd, segmentEnd(1)) || !resizeFile(journalFd, 0)) {
+        LOG_ERROR("Failed to reset storage file: " + std::string(std::strerror(errno)));
+    }
     LOG_INFO("Storage formatted");
-    LeaveCriticalSection(&cs);
 }
 
-size_t BlockManager::getFreeBlocks() {
-    EnterCriticalSection(&cs);
+bool BlockManager::checkpoint() {
+    std::lock_guard<std::mutex> checkpointLock(checkpointMutex);
+    std::vector<BitmapRegion> regions;
+    {
+        // Only capturing the dirty ranges excludes other threads; the
+        // writes below run while blocks keep being allocated
+        std::unique_lock<std::shared_mutex> lock(metadataMutex);
+        for (size_t i = 0; i < segments.size(); ++i) {
+            Segment& segment = segments[i];
+            if (segment.dirtyBegin >= segment.dirtyEnd) {
+                continue;
+            }
+            BitmapRegion region{i, segment.dirtyBegin, segment.bitmapOffset + segment.dirtyBegin * 8, {}};
+            packWords(segment.bitmap, segment.dirtyBegin, segment.dirtyEnd, region.bytes);
+            regions.push_back(std::move(region));
+            segment.dirtyBegin = segment.dirtyEnd = 0;
+        }
+        changesSinceCheckpoint = 0;
+    }
+    if (regions.empty()) {
+        return true;
+    }
+
+    // Journal first: a crash before it is synced leaves the old bitmaps, a
+    // crash after it is replayed on the next open
+    bool written = writeJournal(regions);
+    for (size_t i = 0; written && i < regions.size(); ++i) {
+        written = writeAt(fd, reinterpret_cast<const char*>(regions[i].bytes.data()), regions[i].bytes.size(),
+                          regions[i].offset);
+    }
+    written = written && syncFile(fd) && resizeFile(journalFd, 0);
+    if (!written) {
+        LOG_ERROR("Failed to checkpoint block bitmap: " + std::string(std::strerror(errno)));
+        // Keep the ranges dirty so the next checkpoint retries them
+        std::unique_lock<std::shared_mutex> lock(metadataMutex);
+        for (const auto& region : regions) {
+            if (region.segment < segments.size()) {
+                Segment& segment = segments[region.segment];
+                markDirty(segment, region.firstWord);
+                markDirty(segment, region.firstWord + region.bytes.size() / 8 - 1);
+            }
+        }
+        return false;
+    }
+    LOG_DEBUG("Checkpointed " + std::to_string(regions.size()) + " bitmap ranges");
+    return true;
+}
+
+bool BlockManager::sync() {
+    if (!checkpoint()) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
+    if (!syncFile(fd)) {
+        LOG_ERROR("Failed to sync storage: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+size_t BlockManager::getTotalBlocks() const {
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
+    return totalBlocks;
+}
+
+size_t BlockManager::getFreeBlocks() const {
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
     size_t count = 0;
-    for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-        if (!getBit(i)) ++count;
+    for (const auto& segment : segments) {
+        count += segment.freeBlocks;
     }
-    LeaveCriticalSection(&cs);
     return count;
 }
 
-bool BlockManager::isBlockFree(int blockId) {
+bool BlockManager::isBlockFree(int blockId) const {
+    std::shared_lock<std::shared_mutex> lock(metadataMutex);
     if (!validateBlockId(blockId)) return true;
-    EnterCriticalSection(&cs);
-    bool result = !getBit(blockId);
-    LeaveCriticalSection(&cs);
-    return result;
+    return !getBit(blockId);
 }
 
 // Private helper methods
 bool BlockManager::initializeStorage() {
-    storageFile.open(storagePath, std::ios::in | std::ios::out | std::ios::binary);
-    if (!storageFile) {
-        // Create new storage file
-        storageFile.clear();
-        storageFile.open(storagePath, std::ios::out | std::ios::binary);
-        if (!storageFile) return false;
-        
-        // Initialize with empty blocks
-        std::vector<char> emptyBlock(BLOCK_SIZE, 0);
-        for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-            storageFile.write(emptyBlock.data(), BLOCK_SIZE);
-        }
-        storageFile.close();
-        
-        // Reopen in read/write mode
-        storageFile.open(storagePath, std::ios::in | std::ios::out | std::ios::binary);
-        return storageFile.good();
+    fd = openFile(storagePath);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open storage " + storagePath + ": " + std::strerror(errno));
+        return false;
+    }
+    journalFd = openFile(journalPath);
+    // A replayed journal may extend the file, so it runs before sizing
+    if (journalFd < 0 || !replayJournal()) {
+        LOG_ERROR("Failed to recover bitmap journal " + journalPath + ": " + std::strerror(errno));
+        closeFile(journalFd);
+        closeFile(fd);
+        journalFd = fd = -1;
+        return false;
+    }
+    // Whole segments only: a new file gets segment 0, a partly extended
+    // tail is completed; the new blocks read as zeros
+    uint64_t size = fileSize(fd);
+    size_t segmentCount = 1;
+    while (size > segmentEnd(segmentCount)) {
+        segmentCount++;
+    }
+    if (size < segmentEnd(segmentCount) && !resizeFile(fd, segmentEnd(segmentCount))) {
+        LOG_ERROR("Failed to size storage " + storagePath + ": " + std::strerror(errno));
+        closeFile(fd);
+        fd = -1;
+        return false;
+    }
+    for (size_t i = 0; i < segmentCount; ++i) {
+        addSegment();
     }
     return true;
 }
 
 void BlockManager::loadBitmap() {
-    EnterCriticalSection(&cs);
-    storageFile.seekg(0);
-    storageFile.read(reinterpret_cast<char*>(blockBitmap.data()), BITMAP_BYTES);
-    LeaveCriticalSection(&cs);
+    std::unique_lock<std::shared_mutex> lock(metadataMutex);
+    std::vector<uint8_t> bytes;
+    for (auto& segment : segments) {
+        bytes.assign(segment.bitmap.size() * 8, 0);
+        readAt(fd, reinterpret_cast<char*>(bytes.data()), bytes.size(), segment.bitmapOffset);
+        unpackWords(bytes, segment.bitmap);
+        size_t used = 0;
+        for (uint64_t word : segment.bitmap) {
+            used += popCount(word);
+        }
+        segment.freeBlocks = segment.blockCount - used;
+    }
+}
+
+bool BlockManager::replayJournal() {
+    uint64_t size = fileSize(journalFd);
+    if (size == 0) {
+        return true;
+    }
+    std::vector<uint8_t> journal(static_cast<size_t>(size));
+    if (!readAt(journalFd, reinterpret_cast<char*>(journal.data()), journal.size(), 0)) {
+        return false;
+    }
+
+    // Parse everything before touching the store; a torn journal means
+    // the checkpoint never started its in-place writes
+    std::vector<BitmapRegion> regions;
+    size_t pos = 0;
+    uint64_t magic = 0;
+    uint64_t count = 0;
+    uint64_t checksum = 0;
+    bool valid = getInt(journal, pos, 4, magic) && magic == JOURNAL_MAGIC && getInt(journal, pos, 4, count);
+    for (uint64_t i = 0; valid && i < count; ++i) {
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        valid = getInt(journal, pos, 8, offset) && getInt(journal, pos, 4, length) && journal.size() - pos >= length;
+        if (valid) {
+            regions.push_back(BitmapRegion{0, 0, offset, std::vector<uint8_t>(journal.begin() + pos,
+                                                                             journal.begin() + pos + length)});
+            pos += length;
+        }
+    }
+    size_t checksummed = pos;
+    valid = valid && getInt(journal, pos, 8, checksum) && checksum == fnv1a(journal.data(), checksummed);
+
+    if (valid) {
+        for (const auto& region : regions) {
+            if (!writeAt(fd, reinterpret_cast<const char*>(region.bytes.data()), region.bytes.size(), region.offset)) {
+                return false;
+            }
+        }
+        if (!syncFile(fd)) {
+            return false;
+        }
+        LOG_INFO("Replayed " + std::to_string(regions.size()) + " bitmap ranges from " + journalPath);
+    } else {
+        LOG_INFO("Discarded incomplete bitmap journal " + journalPath);
+    }
+    return resizeFile(journalFd, 0) && syncFile(journalFd);
+}
+
+bool BlockManager::writeJournal(const std::vector<BitmapRegion>& regions) {
+    std::vector<uint8_t> journal;
+    putInt(journal, JOURNAL_MAGIC, 4);
+    putInt(journal, regions.size(), 4);
+    for (const auto& region : regions) {
+        putInt(journal, region.offset, 8);
+        putInt(journal, region.bytes.size(), 4);
+        journal.insert(journal.end(), region.bytes.begin(), region.bytes.end());
+    }
+    putInt(journal, fnv1a(journal.data(), journal.size()), 8);
+    return resizeFile(journalFd, 0) &&
+           writeAt(journalFd, reinterpret_cast<const char*>(journal.data()), journal.size(), 0) &&
+           syncFile(journalFd);
 }
 
-void BlockManager::saveBitmap() {
-    storageFile.seekp(0);
-    storageFile.write(reinterpret_cast<const char*>(blockBitmap.data()), BITMAP_BYTES);
-    storageFile.flush();
+void BlockManager::markDirty(Segment& segment, size_t word) {
+    if (segment.dirtyBegin >= segment.dirtyEnd) {
+        segment.dirtyBegin = word;
+        segment.dirtyEnd = word + 1;
+    } else {
+        segment.dirtyBegin = std::min(segment.dirtyBegin, word);
+        segment.dirtyEnd = std::max(segment.dirtyEnd, word + 1);
+    }
+}
+
+bool BlockManager::growStorage() {
+    if (totalBlocks + SEGMENT_BLOCKS > MAX_BLOCKS) {
+        return false;
+    }
+    // One large extension instead of one per block; on most file systems
+    // the new range stays sparse until written
+    if (!resizeFile(fd, segmentEnd(segments.size() + 1))) {
+        LOG_ERROR("Failed to grow storage: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    // The new bitmap reads as zeros, all free, so there is nothing to write
+    addSegment();
+    LOG_INFO("Storage grown to " + std::to_string(totalBlocks) + " blocks");
+    return true;
+}
+
+void BlockManager::addSegment() {
+    Segment segment;
+    segment.firstBlock = totalBlocks;
+    if (segments.empty()) {
+        segment.blockCount = INITIAL_BLOCKS;
+        segment.bitmapOffset = 0;
+        segment.dataOffset = BITMAP_BYTES;
+        segment.bitmap.assign(BITMAP_BYTES / 8, 0);
+    } else {
+        segment.blockCount = SEGMENT_BLOCKS;
+        segment.bitmapOffset = segmentEnd(segments.size());
+        segment.dataOffset = segment.bitmapOffset + SEGMENT_BITMAP_BYTES;
+        segment.bitmap.assign(SEGMENT_BITMAP_BYTES / 8, 0);
+    }
+    segment.freeBlocks = segment.blockCount;
+    totalBlocks += segment.blockCount;
+    segments.push_back(std::move(segment));
+}
+
+uint64_t BlockManager::segmentEnd(size_t segmentCount) {
+    uint64_t end = BITMAP_BYTES + static_cast<uint64_t>(INITIAL_BLOCKS) * BLOCK_SIZE;
+    return end + (segmentCount - 1) * (SEGMENT_BITMAP_BYTES + static_cast<uint64_t>(SEGMENT_BLOCKS) * BLOCK_SIZE);
 }
 
 bool BlockManager::validateBlockId(int blockId) const {
-    return blockId >= 0 && static_cast<size_t>(blockId) < MAX_BLOCKS;
+    return blockId >= 0 && static_cast<size_t>(blockId) < totalBlocks;
+}
+
+size_t BlockManager::segmentIndex(size_t index) const {
+    return index < INITIAL_BLOCKS ? 0 : 1 + (index - INITIAL_BLOCKS) / SEGMENT_BLOCKS;
+}
+
+BlockManager::Segment& BlockManager::segmentOf(size_t index) {
+    return segments[segmentIndex(index)];
+}
+
+const BlockManager::Segment& BlockManager::segmentOf(size_t index) const {
+    return segments[segmentIndex(index)];
 }
 
 size_t BlockManager::getBlockOffset(int blockId) const {
-    return static_cast<size_t>(blockId) * BLOCK_SIZE + BITMAP_BYTES;
+    const Segment& segment = segmentOf(blockId);
+    return segment.dataOffset + (static_cast<size_t>(blockId) - segment.firstBlock) * BLOCK_SIZE;
+}
+
+bool BlockManager::isRangeAllocated(int firstBlock, size_t count) const {
+    if (count == 0 || !validateBlockId(firstBlock) || count > totalBlocks - firstBlock) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!getBit(firstBlock + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t BlockManager::contiguousBlocks(size_t index, size_t count) const {
+    const Segment& segment = segmentOf(index);
+    return std::min(count, segment.firstBlock + segment.blockCount - index);
+}
+
+size_t BlockManager::findFree(const Segment& segment, size_t local) const {
+    size_t w = local / 64;
+    if (w >= segment.bitmap.size()) {
+        return segment.blockCount;
+    }
+    uint64_t bits = ~segment.bitmap[w] & (~uint64_t{0} << (local % 64));
+    while (bits == 0) {
+        if (++w == segment.bitmap.size()) {
+            return segment.blockCount;
+        }
+        bits = ~segment.bitmap[w];
+    }
+    return w * 64 + countTrailingZeros(bits);
+}
+
+size_t BlockManager::findUsed(const Segment& segment, size_t local) const {
+    size_t w = local / 64;
+    if (w >= segment.bitmap.size()) {
+        return segment.blockCount;
+    }
+    uint64_t bits = segment.bitmap[w] & (~uint64_t{0} << (local % 64));
+    while (bits == 0) {
+        if (++w == segment.bitmap.size()) {
+            return segment.blockCount;
+        }
+        bits = segment.bitmap[w];
+    }
+    return w * 64 + countTrailingZeros(bits);
+}
+
+size_t BlockManager::findExtent(const Segment& segment, size_t count) const {
+    // Walk the free runs a word at a time; the shortest one that fits
+    // leaves the long runs for later large extents
+    size_t best = segment.blockCount;
+    size_t bestLength = std::numeric_limits<size_t>::max();
+    for (size_t start = findFree(segment, segment.searchWord * 64); start < segment.blockCount;) {
+        size_t end = findUsed(segment, start);
+        size_t length = end - start;
+        if (length >= count && length < bestLength) {
+            best = start;
+            bestLength = length;
+            if (length == count) {
+                break;
+            }
+        }
+        start = findFree(segment, end);
+    }
+    return best;
 }
 
 bool BlockManager::setBit(size_t index, bool value) {
-    if (index >= MAX_BLOCKS) return false;
-    size_t byteIndex = index / 8;
-    size_t bitIndex = index % 8;
+    if (index >= totalBlocks) return false;
+    size_t segmentId = segmentIndex(index);
+    Segment& segment = segments[segmentId];
+    size_t local = index - segment.firstBlock;
+    uint64_t& word = segment.bitmap[local / 64];
+    uint64_t mask = uint64_t{1} << (local % 64);
+    bool wasSet = (word & mask) != 0;
     if (value) {
-        blockBitmap[byteIndex] |= (1 << bitIndex);
+        word |= mask;
     } else {
-        blockBitmap[byteIndex] &= ~(1 << bitIndex);
+        word &= ~mask;
+        segment.searchWord = std::min(segment.searchWord, local / 64);
+        searchSegment = std::min(searchSegment, segmentId);
+    }
+    if (wasSet != value) {
+        value ? segment.freeBlocks-- : segment.freeBlocks++;
+        markDirty(segment, local / 64);
     }
     return true;
 }
 
-bool BlockManager::getBit(size_t index) {
-    if (index >= MAX_BLOCKS) return false;
-    size_t byteIndex = index / 8;
-    size_t bitIndex = index % 8;
-    return (blockBitmap[byteIndex] & (1 << bitIndex)) != 0;
+bool BlockManager::getBit(size_t index) const {
+    if (index >= totalBlocks) return false;
+    const Segment& segment = segmentOf(index);
+    size_t local = index - segment.firstBlock;
+    return (segment.bitmap[local / 64] >> (local % 64)) & 1;
 }
 
-} // namespace mtfs::storage 
\ No newline at end of file
+} // namespace mtfs::storage
@@ -4,6 +4,11 @@
 #include <string>
 #include <vector>
 #include <cassert>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 
 using namespace mtfs::storage;
 using namespace mtfs::common;
@@ -69,6 +74,169 @@ int main() {
             throw std::runtime_error("Successfully read a freed block (unexpected)");
         }
 
+        // Concurrent I/O: each thread owns some blocks and keeps rewriting
+        // and re-reading them while the others do the same
+        std::cout << "\nConcurrent block I/O...\n";
+        const int threadCount = 8;
+        const int blocksPerThread = 16;
+        std::vector<int> ids;
+        for (int i = 0; i < threadCount * blocksPerThread; ++i) {
+            ids.push_back(blockManager.allocateBlock());
+            assert(ids.back() >= 0 && "Failed to allocate block");
+        }
+        std::atomic<int> mismatches{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::vector<char> in;
+                for (int round = 0; round < 50; ++round) {
+                    for (int b = 0; b < blocksPerThread; ++b) {
+                        int id = ids[t * blocksPerThread + b];
+                        std::vector<char> out(BlockManager::BLOCK_SIZE, static_cast<char>('A' + (t + round) % 26));
+                        if (!blockManager.writeBlock(id, out) || !blockManager.readBlock(id, in) || in != out) {
+                            mismatches++;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::cout << "Concurrent verification: " << (mismatches == 0 ? "PASSED" : "FAILED") << std::endl;
+        assert(mismatches == 0 && "Concurrent block I/O returned wrong data");
+        for (int id : ids) {
+            blockManager.freeBlock(id);
+        }
+        std::cout << "Free blocks: " << blockManager.getFreeBlocks() << "/" << blockManager.getTotalBlocks() << std::endl;
+
+        // Online growth: filling the initial blocks extends the store by a
+        // segment instead of failing, and the new size survives a reopen
+        std::cout << "\nGrowing past the initial size...\n";
+        const std::string growthPath = "./test_growth_storage.bin";
+        int highBlock = -1;
+        size_t allocated = BlockManager::INITIAL_BLOCKS + 10;
+        {
+            BlockManager growing(growthPath);
+            growing.formatStorage();
+            for (size_t i = 0; i < allocated; ++i) {
+                highBlock = growing.allocateBlock();
+                assert(highBlock >= 0 && "Failed to allocate while growing");
+            }
+            assert(static_cast<size_t>(highBlock) >= BlockManager::INITIAL_BLOCKS);
+            assert(growing.getTotalBlocks() == BlockManager::INITIAL_BLOCKS + BlockManager::SEGMENT_BLOCKS);
+            assert(growing.getFreeBlocks() == growing.getTotalBlocks() - allocated);
+            if (!growing.writeBlock(highBlock, std::vector<char>(BlockManager::BLOCK_SIZE, 'G'))) {
+                throw std::runtime_error("Failed to write a block in the grown segment");
+            }
+            std::cout << "Free blocks: " << growing.getFreeBlocks() << "/" << growing.getTotalBlocks() << std::endl;
+
+            // Freed blocks are found again, lowest first, across segments
+            growing.freeBlock(highBlock);
+            growing.freeBlock(5);
+            int reused = growing.allocateBlock();
+            assert(reused == 5 && "Expected the lowest free block");
+            reused = growing.allocateBlock();
+            assert(reused == highBlock && "Expected the freed block in the grown segment");
+            std::cout << "Free-space search reused freed blocks: PASSED" << std::endl;
+        }
+        {
+            BlockManager reopened(growthPath);
+            assert(reopened.getTotalBlocks() == BlockManager::INITIAL_BLOCKS + BlockManager::SEGMENT_BLOCKS);
+            assert(reopened.getFreeBlocks() == reopened.getTotalBlocks() - allocated);
+            if (!reopened.readBlock(highBlock, readData)) {
+                throw std::runtime_error("Failed to read a grown block after reopening");
+            }
+            assert(readData[0] == 'G' && readData.back() == 'G');
+            reopened.formatStorage();
+            assert(reopened.getTotalBlocks() == BlockManager::INITIAL_BLOCKS);
+            std::cout << "Reopened store kept its size and data: PASSED" << std::endl;
+        }
+        std::remove(growthPath.c_str());
+
+        // Bitmap changes reach the file at checkpoints, not on every
+        // allocation: a copy of the file taken after sync() plus more
+        // allocations looks exactly like the store at the sync
+        std::cout << "\nCheckpointed bitmap persistence...\n";
+        const std::string livePath = "./test_checkpoint_storage.bin";
+        const std::string crashPath = "./test_crash_storage.bin";
+        {
+            BlockManager live(livePath);
+            live.formatStorage();
+            for (int i = 0; i < 10; ++i) {
+                live.allocateBlock();
+            }
+            if (!live.sync()) {
+                throw std::runtime_error("Failed to sync storage");
+            }
+            for (int i = 0; i < 5; ++i) {
+                live.allocateBlock();
+            }
+            std::ifstream source(livePath, std::ios::binary);
+            std::ofstream copy(crashPath, std::ios::binary | std::ios::trunc);
+            copy << source.rdbuf();
+        }
+        {
+            // A torn journal left by the crash is dropped, not replayed
+            std::ofstream torn(crashPath + ".bitmap-journal", std::ios::binary | std::ios::trunc);
+            torn << "MTBJ partial";
+        }
+        {
+            BlockManager crashed(crashPath);
+            assert(crashed.getFreeBlocks() == crashed.getTotalBlocks() - 10);
+            assert(!crashed.isBlockFree(9) && crashed.isBlockFree(10));
+            std::cout << "Recovered the last checkpoint: PASSED" << std::endl;
+        }
+        {
+            BlockManager reopened(livePath);
+            assert(reopened.getFreeBlocks() == reopened.getTotalBlocks() - 15);
+            std::cout << "Clean close kept every allocation: PASSED" << std::endl;
+        }
+        std::remove(livePath.c_str());
+        std::remove(crashPath.c_str());
+
+        // Extents: contiguous runs, chosen best fit, written and read
+        // back with one call
+        std::cout << "\nExtent allocation...\n";
+        {
+            BlockManager extents("./test_extent_storage.bin");
+            extents.formatStorage();
+            int first = extents.allocateBlocks(100);
+            assert(first == 0 && "Expected the extent at the start of a fresh store");
+            for (int id = first; id < first + 100; ++id) {
+                assert(!extents.isBlockFree(id));
+            }
+
+            std::vector<char> large(100 * BlockManager::BLOCK_SIZE - 10);
+            for (size_t i = 0; i < large.size(); ++i) {
+                large[i] = static_cast<char>('a' + i % 26);
+            }
+            if (!extents.writeBlocks(first, large)) {
+                throw std::runtime_error("Failed to write extent");
+            }
+            std::vector<char> largeRead;
+            if (!extents.readBlocks(first, 100, largeRead)) {
+                throw std::runtime_error("Failed to read extent");
+            }
+            assert(std::equal(large.begin(), large.end(), largeRead.begin()) && largeRead.back() == 0);
+            assert(!extents.readBlocks(first + 90, 20, largeRead) && "Read past the extent should fail");
+
+            // Holes of 10 and 3 blocks: a 3-block extent takes the smaller
+            extents.freeBlocks(first + 10, 10);
+            extents.freeBlocks(first + 50, 3);
+            int fitted = extents.allocateBlocks(3);
+            assert(fitted == first + 50 && "Expected the best-fitting hole");
+            assert(!extents.freeBlocks(first + 10, 11) && "Freeing a partly free range should fail");
+
+            // An extent that fits in no run starts a new segment
+            int spanning = extents.allocateBlocks(2000);
+            assert(spanning == static_cast<int>(BlockManager::INITIAL_BLOCKS));
+            assert(extents.getTotalBlocks() == BlockManager::INITIAL_BLOCKS + BlockManager::SEGMENT_BLOCKS);
+            assert(extents.allocateBlocks(BlockManager::SEGMENT_BLOCKS + 1) == -1);
+            std::cout << "Contiguous, best-fit extents: PASSED" << std::endl;
+        }
+        std::remove("./test_extent_storage.bin");
+
         std::cout << "\nAll tests completed successfully!\n";
         return 0;
 
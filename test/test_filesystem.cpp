@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include "fs/filesystem.hpp"
+#include "fs/page_cache.hpp"
 #include "common/error.hpp"
 #include <filesystem>
+#include <fstream>
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <chrono>
@@ -123,6 +126,679 @@ TEST_F(FileSystemTest, LargeFileOperations) {
     ASSERT_EQ(readData, largeData);
 }
 
+// Test zero-copy reads through the shared cache buffer
+TEST_F(FileSystemTest, SharedBufferReads) {
+    const std::string testFile = "shared.txt";
+    const std::string testData = "Shared immutable cache buffer";
+
+    ASSERT_TRUE(fs->createFile(testFile));
+    ASSERT_TRUE(fs->writeFile(testFile, testData));
+
+    auto first = fs->readFileShared(testFile);
+    auto second = fs->readFileShared(testFile);
+    ASSERT_EQ(*first, testData);
+    // Both hits reference the same cached bytes
+    ASSERT_EQ(first.get(), second.get());
+    ASSERT_EQ(fs->readFile(testFile), testData);
+}
+
+// Policy switches and resizes keep the cache warm
+TEST_F(FileSystemTest, CacheSurvivesPolicySwitch) {
+    const std::string hotFile = "hot.txt";
+    const std::string coldFile = "cold.txt";
+    const std::string hotData(64, 'h');
+    const std::string coldData(64, 'c');
+
+    ASSERT_TRUE(fs->createFile(hotFile));
+    ASSERT_TRUE(fs->writeFile(hotFile, hotData));
+    ASSERT_TRUE(fs->createFile(coldFile));
+    ASSERT_TRUE(fs->writeFile(coldFile, coldData));
+    fs->pinFile(hotFile);
+
+    auto before = fs->getCacheStatistics();
+    fs->setCachePolicy(mtfs::cache::CachePolicy::LIFO);
+    auto after = fs->getCacheStatistics();
+    ASSERT_EQ(after.residentBytes, before.residentBytes);
+    ASSERT_TRUE(fs->isFilePinned(hotFile));
+
+    // A smaller budget that still fits everything evicts nothing
+    fs->resizeCache(1024 * 1024);
+    ASSERT_TRUE(fs->isFilePinned(hotFile));
+    ASSERT_EQ(fs->getCacheStatistics().residentBytes, before.residentBytes);
+    ASSERT_EQ(fs->getCacheStatistics().evictions, before.evictions);
+    ASSERT_EQ(fs->readFile(hotFile), hotData);
+}
+
+// Offset I/O goes through the page cache and is written back on sync()
+TEST_F(FileSystemTest, PageCacheWriteBack) {
+    const std::string testFile = "paged.dat";
+    const std::string block(10000, 'p');
+    const std::string patch = "PATCH";
+
+    ASSERT_TRUE(fs->createFile(testFile));
+    ASSERT_EQ(fs->write(testFile, block.data(), block.size(), 0), block.size());
+    ASSERT_EQ(fs->write(testFile, patch.data(), patch.size(), 5000), patch.size());
+    ASSERT_GT(fs->getPageCacheStatistics().dirtyPages, 0u);
+
+    // Repeated small reads are served from resident pages
+    char buffer[16] = {};
+    auto misses = fs->getPageCacheStatistics().misses;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(fs->read(testFile, buffer, patch.size(), 5000), patch.size());
+    }
+    ASSERT_EQ(std::string(buffer, patch.size()), patch);
+    ASSERT_EQ(fs->getPageCacheStatistics().misses, misses);
+
+    fs->sync();
+    ASSERT_EQ(fs->getPageCacheStatistics().dirtyPages, 0u);
+    std::string expected = block;
+    expected.replace(5000, patch.size(), patch);
+    ASSERT_EQ(fs->readFile(testFile), expected);
+}
+
+// A write that evicts pages of its own file keeps every byte it wrote
+TEST_F(FileSystemTest, PageCacheSelfEvictingWrite) {
+    constexpr size_t PAGE = mtfs::fs::PageCache::PAGE_SIZE;
+    const std::string path = (testRootPath / "self_evict.dat").string();
+    std::ofstream(path, std::ios::binary).close();
+
+    std::string data(4 * PAGE, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>('a' + i / PAGE);
+    }
+    {
+        mtfs::fs::PageCache cache(2);
+        ASSERT_EQ(cache.write(path, data.data(), PAGE, 0), PAGE);
+        ASSERT_EQ(cache.write(path, data.data() + PAGE, 3 * PAGE, PAGE), 3 * PAGE);
+        cache.flushAll();
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::string onDisk((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(onDisk, data);
+}
+
+// Files whose pages were all evicted are no longer tracked
+TEST_F(FileSystemTest, PageCacheForgetsEvictedFiles) {
+    mtfs::fs::PageCache cache(2);
+    char buffer[8] = {};
+    for (int i = 0; i < 10; ++i) {
+        const std::string path = (testRootPath / ("page_" + std::to_string(i) + ".dat")).string();
+        std::ofstream(path, std::ios::binary) << "page " << i;
+        ASSERT_GT(cache.read(path, buffer, sizeof(buffer), 0), 0u);
+    }
+    ASSERT_EQ(cache.getStats().residentPages, 2u);
+    ASSERT_EQ(cache.getStats().trackedFiles, 2u);
+}
+
+// Pages that fail to reach the disk stay dirty and the flush reports it
+TEST_F(FileSystemTest, PageCacheFailedWriteBack) {
+    // Every write to /dev/full fails with ENOSPC
+    if (!std::filesystem::exists("/dev/full")) {
+        GTEST_SKIP() << "needs /dev/full";
+    }
+    mtfs::fs::PageCache cache(4);
+    const std::string data = "never stored";
+    ASSERT_EQ(cache.write("/dev/full", data.data(), data.size(), 0), data.size());
+    ASSERT_THROW(cache.flushAll(), mtfs::common::FSException);
+    ASSERT_EQ(cache.getStats().dirtyPages, 1u);
+    ASSERT_EQ(cache.getStats().writebacks, 0u);
+    cache.discard("/dev/full");
+}
+
+// Deleting one file must not evict the rest of the cache
+TEST_F(FileSystemTest, TargetedCacheInvalidation) {
+    ASSERT_TRUE(fs->createDirectory("docs"));
+    ASSERT_TRUE(fs->createFile("keep.txt"));
+    ASSERT_TRUE(fs->writeFile("keep.txt", "keep"));
+    ASSERT_TRUE(fs->createFile("gone.txt"));
+    ASSERT_TRUE(fs->writeFile("gone.txt", "gone"));
+    ASSERT_TRUE(fs->createFile("docs/a.txt"));
+    ASSERT_TRUE(fs->writeFile("docs/a.txt", "a"));
+
+    ASSERT_TRUE(fs->deleteFile("gone.txt"));
+    auto hits = fs->getCacheStatistics().hits;
+    ASSERT_EQ(fs->readFile("keep.txt"), "keep");
+    ASSERT_EQ(fs->getCacheStatistics().hits, hits + 1);
+
+    // Directory invalidation only drops entries below that directory
+    fs->invalidateCachedDirectory("docs/");
+    hits = fs->getCacheStatistics().hits;
+    ASSERT_EQ(fs->readFile("docs/a.txt"), "a");
+    ASSERT_EQ(fs->readFile("keep.txt"), "keep");
+    ASSERT_EQ(fs->getCacheStatistics().hits, hits + 1);
+}
+
+// Sequential reads pull the next files in the series in the background
+TEST_F(FileSystemTest, SequentialPrefetch) {
+    ASSERT_TRUE(fs->createDirectory("seq"));
+    for (int i = 0; i < 8; ++i) {
+        std::string name = "seq/part_0" + std::to_string(i) + ".dat";
+        ASSERT_TRUE(fs->createFile(name));
+        ASSERT_TRUE(fs->writeFile(name, "chunk " + std::to_string(i)));
+    }
+    fs->clearCache();
+
+    ASSERT_EQ(fs->readFile("seq/part_00.dat"), "chunk 0");
+    ASSERT_EQ(fs->readFile("seq/part_01.dat"), "chunk 1");
+    fs->waitForPrefetches();
+    ASSERT_GT(fs->getPrefetchStatistics().completed, 0u);
+
+    auto hits = fs->getCacheStatistics().hits;
+    ASSERT_EQ(fs->readFile("seq/part_02.dat"), "chunk 2");
+    ASSERT_EQ(fs->getCacheStatistics().hits, hits + 1);
+    ASSERT_GE(fs->getPrefetchStatistics().used, 1u);
+}
+
+// The hot set saved at unmount is reloaded in the background on mount
+TEST_F(FileSystemTest, WarmStartSnapshot) {
+    ASSERT_TRUE(fs->createFile("hot.txt"));
+    ASSERT_TRUE(fs->writeFile("hot.txt", "hot"));
+    ASSERT_TRUE(fs->createFile("pinned.txt"));
+    ASSERT_TRUE(fs->writeFile("pinned.txt", "pinned"));
+    fs->pinFile("pinned.txt");
+    fs->unmount();
+    ASSERT_EQ(fs->getWarmStartStats().lastSnapshotEntries, 2u);
+
+    // A fresh instance starts cold and warms up from the snapshot
+    fs = mtfs::fs::FileSystem::create(testRootPath.string());
+    fs->mount();
+    fs->waitForCacheWarmup();
+    ASSERT_EQ(fs->getWarmStartStats().restored, 2u);
+    ASSERT_TRUE(fs->isFilePinned("pinned.txt"));
+
+    auto hits = fs->getCacheStatistics().hits;
+    ASSERT_EQ(fs->readFile("hot.txt"), "hot");
+    ASSERT_EQ(fs->getCacheStatistics().hits, hits + 1);
+    fs->unmount();
+}
+
+// A snapshot with a corrupt key length is ignored instead of failing mount
+TEST_F(FileSystemTest, CorruptWarmStartSnapshot) {
+    ASSERT_TRUE(fs->createFile("hot.txt"));
+    ASSERT_TRUE(fs->writeFile("hot.txt", "hot"));
+    fs->unmount();
+
+    // Magic, version and count, then the first entry's access count and
+    // pin flag come before its key length
+    {
+        std::fstream snapshot(testRootPath / ".mtfs_cache_snapshot",
+                              std::ios::binary | std::ios::in | std::ios::out);
+        ASSERT_TRUE(snapshot);
+        snapshot.seekp(8 + 4 + 4 + 4 + 1);
+        const uint32_t keyLength = 0xFFFFFFF0u;
+        snapshot.write(reinterpret_cast<const char*>(&keyLength), sizeof(keyLength));
+    }
+
+    fs = mtfs::fs::FileSystem::create(testRootPath.string());
+    ASSERT_NO_THROW(fs->mount());
+    fs->waitForCacheWarmup();
+    ASSERT_EQ(fs->getWarmStartStats().restored, 0u);
+    ASSERT_EQ(fs->readFile("hot.txt"), "hot");
+    fs->unmount();
+}
+
+// CLOCK-Pro keeps a re-read working set resident through one-pass scans
+TEST_F(FileSystemTest, ClockProScanResistance) {
+    const std::string hotData(1024, 'h');
+    const std::string scanData(1024, 's');
+    fs->setPrefetchEnabled(false);
+    fs->setCachePolicy(mtfs::cache::CachePolicy::CLOCK_PRO);
+    fs->resizeCache(16 * 8 * 1024);  // About eight files per shard
+
+    for (int i = 0; i < 4; ++i) {
+        std::string name = "hot_" + std::to_string(i) + ".dat";
+        ASSERT_TRUE(fs->createFile(name));
+        ASSERT_TRUE(fs->writeFile(name, hotData));
+    }
+    for (int i = 0; i < 1200; ++i) {
+        std::string name = "scan_" + std::to_string(i) + ".dat";
+        ASSERT_TRUE(fs->createFile(name));
+        ASSERT_TRUE(fs->writeFile(name, scanData));
+    }
+    fs->clearCache();
+
+    // Every scan pass is several times the cache; an LRU would come out of
+    // each one with none of the hot files left
+    size_t hotHits = 0;
+    for (int round = 0; round < 6; ++round) {
+        auto hits = fs->getCacheStatistics().hits;
+        for (int h = 0; h < 4; ++h) {
+            for (int repeat = 0; repeat < 3; ++repeat) {
+                ASSERT_EQ(fs->readFile("hot_" + std::to_string(h) + ".dat"), hotData);
+            }
+        }
+        hotHits = fs->getCacheStatistics().hits - hits;
+        for (int i = round * 200; i < (round + 1) * 200; ++i) {
+            ASSERT_EQ(fs->readFile("scan_" + std::to_string(i) + ".dat"), scanData);
+        }
+    }
+    ASSERT_EQ(hotHits, 12u);
+}
+
+// ARC keeps keys seen twice through a one-pass scan larger than the cache
+TEST_F(FileSystemTest, ArcScanResistance) {
+    mtfs::cache::CacheManager<int, int> cache(16, mtfs::cache::CachePolicy::ARC);
+    for (int key = 0; key < 4; ++key) {
+        cache.put(key, key);
+        ASSERT_TRUE(cache.tryGet(key));
+    }
+    for (int key = 100; key < 200; ++key) {
+        cache.put(key, key);
+    }
+    for (int key = 0; key < 4; ++key) {
+        ASSERT_TRUE(cache.contains(key)) << "hot key " << key << " lost to the scan";
+    }
+}
+
+// TinyLFU drops a one-hit key in favour of a popular victim and admits
+// a key that has been asked for more often than the victim
+TEST_F(FileSystemTest, TinyLfuAdmission) {
+    mtfs::cache::CacheManager<int, int> cache(4, mtfs::cache::CachePolicy::LRU);
+    cache.setAdmissionPolicy(mtfs::cache::AdmissionPolicy::TinyLFU);
+    for (int key = 1; key <= 4; ++key) {
+        cache.put(key, key);
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (int key = 1; key <= 4; ++key) {
+            ASSERT_TRUE(cache.tryGet(key));
+        }
+    }
+
+    cache.put(99, 99);
+    ASSERT_FALSE(cache.contains(99));
+    ASSERT_EQ(cache.getStatistics().admissionsRejected, 1u);
+    ASSERT_EQ(cache.getStatistics().admissionsAccepted, 0u);
+    for (int key = 1; key <= 4; ++key) {
+        ASSERT_TRUE(cache.contains(key));
+    }
+
+    // Misses count too: after enough of them the newcomer wins
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_FALSE(cache.tryGet(50));
+    }
+    cache.put(50, 50);
+    ASSERT_TRUE(cache.contains(50));
+    ASSERT_EQ(cache.getStatistics().admissionsAccepted, 1u);
+}
+
+// LFU evicts the least frequently used key, the oldest one among ties; a
+// re-inserted key starts over as the newest with a count of one
+TEST_F(FileSystemTest, LfuEvictsLeastFrequentOldest) {
+    mtfs::cache::CacheManager<int, int> cache(3, mtfs::cache::CachePolicy::LFU);
+    for (int key = 1; key <= 3; ++key) {
+        cache.put(key, key);
+    }
+    ASSERT_TRUE(cache.tryGet(1));
+    ASSERT_TRUE(cache.tryGet(1));
+    ASSERT_TRUE(cache.tryGet(2));
+    ASSERT_TRUE(cache.tryGet(2));
+    cache.remove(2);
+    cache.put(2, 2);
+
+    // 2 and 3 are tied at the lowest count and 3 is older
+    cache.put(4, 4);
+    ASSERT_TRUE(cache.contains(1));
+    ASSERT_TRUE(cache.contains(2));
+    ASSERT_FALSE(cache.contains(3));
+    ASSERT_TRUE(cache.contains(4));
+
+    // 2 is now the oldest of the keys seen once
+    cache.put(5, 5);
+    ASSERT_TRUE(cache.contains(1));
+    ASSERT_FALSE(cache.contains(2));
+    ASSERT_TRUE(cache.contains(4));
+    ASSERT_TRUE(cache.contains(5));
+}
+
+// Lock-free hits stay correct while policy switches and resizes retract
+// and republish the read view and retire the old shards
+TEST_F(FileSystemTest, LockFreeHitsAcrossPolicySwitches) {
+    using mtfs::cache::CachePolicy;
+    mtfs::cache::CacheManager<int, mtfs::cache::SharedBuffer> cache(64 * 1024, CachePolicy::CLOCK, 4);
+    auto valueFor = [](int key) {
+        return std::make_shared<const std::string>(std::string(128, static_cast<char>('a' + key % 26)) +
+                                                   std::to_string(key));
+    };
+
+    constexpr int WORKERS = 4;
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> switches{0};
+    std::atomic<size_t> wrongValues{0};
+    std::atomic<size_t> resurrected{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < WORKERS; ++t) {
+        workers.emplace_back([&, t] {
+            // Each worker owns the keys equal to t modulo WORKERS, so a key it
+            // removed must stay gone until it puts it again. Keep going until
+            // the switcher has had its turns, even on a single core.
+            for (int i = 0; i < 20000 || switches < 32; ++i) {
+                int key = (i * 7 % 512) * WORKERS + t;
+                switch (i % 4) {
+                case 0:
+                    cache.remove(key);
+                    if (cache.tryGet(key)) {
+                        resurrected++;
+                    }
+                    break;
+                case 1:
+                    cache.put(key, valueFor(key));
+                    break;
+                default:
+                    if (auto value = cache.tryGet(key); value && **value != *valueFor(key)) {
+                        wrongValues++;
+                    }
+                }
+            }
+        });
+    }
+
+    const CachePolicy policies[] = {CachePolicy::CLOCK_PRO, CachePolicy::LRU, CachePolicy::ARC,
+                                    CachePolicy::CLOCK};
+    std::thread switcher([&] {
+        for (size_t round = 0; !stop; ++round) {
+            cache.setPolicy(policies[round % 4]);
+            cache.resize(round % 2 ? 32 * 1024 : 64 * 1024);
+            switches++;
+            std::this_thread::yield();
+        }
+    });
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    stop = true;
+    switcher.join();
+
+    ASSERT_EQ(wrongValues, 0u);
+    ASSERT_EQ(resurrected, 0u);
+    for (int key = 0; key < 512 * WORKERS; ++key) {
+        if (auto value = cache.tryGet(key)) {
+            ASSERT_EQ(**value, *valueFor(key));
+        }
+    }
+}
+
+// A key removed and inserted again joins the back of the FIFO queue
+TEST_F(FileSystemTest, FifoReinsertKeepsQueueOrder) {
+    mtfs::cache::CacheManager<int, int> cache(3, mtfs::cache::CachePolicy::FIFO);
+    for (int key = 1; key <= 3; ++key) {
+        cache.put(key, key);
+    }
+    cache.remove(1);
+    cache.put(1, 1);
+
+    // 2 is now the oldest insertion
+    cache.put(4, 4);
+    ASSERT_TRUE(cache.tryGet(1));
+    ASSERT_FALSE(cache.tryGet(2));
+    ASSERT_TRUE(cache.tryGet(3));
+    ASSERT_TRUE(cache.tryGet(4));
+}
+
+// Cached copies are rechecked against the disk and expire after the TTL
+TEST_F(FileSystemTest, CacheValidation) {
+    const std::string testFile = "shared.txt";
+    auto writeBehindOurBack = [&](const std::string& data) {
+        std::ofstream external(testRootPath / testFile, std::ios::trunc);
+        external << data;
+    };
+
+    mtfs::fs::ValidationSettings settings;
+    settings.revalidate = true;
+    settings.revalidateInterval = std::chrono::milliseconds(0);
+    fs->setCacheValidation(settings);
+
+    ASSERT_TRUE(fs->createFile(testFile));
+    ASSERT_TRUE(fs->writeFile(testFile, "original"));
+    ASSERT_EQ(fs->readFile(testFile), "original");
+
+    // Another process rewrites the file: the size no longer matches
+    writeBehindOurBack("changed by another process");
+    ASSERT_EQ(fs->readFile(testFile), "changed by another process");
+    ASSERT_GT(fs->getCacheValidationStatistics().stale, 0u);
+
+    // Without revalidation only the TTL bounds how long a copy is served
+    settings.revalidate = false;
+    settings.ttl = std::chrono::milliseconds(20);
+    fs->setCacheValidation(settings);
+    ASSERT_EQ(fs->readFile(testFile), "changed by another process");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writeBehindOurBack("v3");
+    ASSERT_EQ(fs->readFile(testFile), "v3");
+    ASSERT_GT(fs->getCacheValidationStatistics().expired, 0u);
+}
+
+// Files evicted from memory are served from the disk spill tier
+TEST_F(FileSystemTest, CacheSpillTier) {
+    const size_t fileCount = 200;
+    auto contentOf = [](size_t i) { return std::string(1024, static_cast<char>('a' + i % 26)) + std::to_string(i); };
+    fs->setPrefetchEnabled(false);
+    fs->resizeCache(16 * 8 * 1024);
+    fs->setCacheSpill(4 * 1024 * 1024);
+
+    for (size_t i = 0; i < fileCount; ++i) {
+        std::string name = "spill_" + std::to_string(i) + ".dat";
+        ASSERT_TRUE(fs->createFile(name));
+        ASSERT_TRUE(fs->writeFile(name, contentOf(i)));
+    }
+
+    // Most files no longer fit in memory, but all of them fit on disk
+    auto misses = fs->getCacheStatistics().misses;
+    for (size_t i = 0; i < fileCount; ++i) {
+        ASSERT_EQ(fs->readFile("spill_" + std::to_string(i) + ".dat"), contentOf(i));
+    }
+    auto spillStats = fs->getCacheSpillStatistics();
+    ASSERT_GT(fs->getCacheStatistics().misses - misses, fileCount / 2);
+    ASSERT_EQ(spillStats.hits, fs->getCacheStatistics().misses - misses);
+    ASSERT_EQ(spillStats.misses, 0u);
+
+    // A spilled copy never hides a newer write
+    ASSERT_GT(spillStats.residentEntries, 0u);
+    for (size_t i = 0; i < fileCount; ++i) {
+        ASSERT_TRUE(fs->writeFile("spill_" + std::to_string(i) + ".dat", "rewritten"));
+    }
+    for (size_t i = 0; i < fileCount; ++i) {
+        ASSERT_EQ(fs->readFile("spill_" + std::to_string(i) + ".dat"), "rewritten");
+    }
+
+    fs->clearCache();
+    ASSERT_EQ(fs->getCacheSpillStatistics().residentEntries, 0u);
+    fs->setCacheSpill(0);
+}
+
+// Evicted text files are kept compressed and decompressed on their next hit
+TEST_F(FileSystemTest, CacheCompression) {
+    const size_t fileCount = 100;
+    auto logOf = [](size_t i) {
+        std::string log;
+        for (size_t line = 0; line < 40; ++line) {
+            log += "2026-10-16 12:00:" + std::to_string(line) + " INFO worker " + std::to_string(i) +
+                   " served request " + std::to_string(line * 7) + "\n";
+        }
+        return log;
+    };
+    fs->setPrefetchEnabled(false);
+    fs->resizeCache(16 * 8 * 1024);
+    fs->setCacheCompression(0.5);
+
+    for (size_t i = 0; i < fileCount; ++i) {
+        std::string name = "log_" + std::to_string(i) + ".txt";
+        ASSERT_TRUE(fs->createFile(name));
+        ASSERT_TRUE(fs->writeFile(name, logOf(i)));
+    }
+
+    // The plain half of the budget holds about 30 of these files, the
+    // compressed half the rest
+    auto misses = fs->getCacheStatistics().misses;
+    for (size_t i = 0; i < fileCount; ++i) {
+        ASSERT_EQ(fs->readFile("log_" + std::to_string(i) + ".txt"), logOf(i));
+    }
+    auto compression = fs->getCacheCompressionStatistics();
+    ASSERT_GT(fs->getCacheStatistics().misses - misses, fileCount / 2);
+    ASSERT_EQ(compression.hits, fs->getCacheStatistics().misses - misses);
+    ASSERT_GT(compression.compressionRatio, 2.0);
+    ASSERT_GT(compression.compressNanos, 0u);
+
+    // A compressed copy never hides a newer write
+    for (size_t i = 0; i < fileCount; ++i) {
+        ASSERT_TRUE(fs->writeFile("log_" + std::to_string(i) + ".txt", "rewritten"));
+    }
+    for (size_t i = 0; i < fileCount; ++i) {
+        ASSERT_EQ(fs->readFile("log_" + std::to_string(i) + ".txt"), "rewritten");
+    }
+    fs->setCacheCompression(0);
+}
+
+// A write the admission filter turns away still replaces older copies
+TEST_F(FileSystemTest, RejectedWriteHidesTieredCopy) {
+    fs->setPrefetchEnabled(false);
+    fs->resizeCache(16 * 8 * 1024);
+    fs->setCacheCompression(0.5);
+
+    ASSERT_TRUE(fs->createFile("cold.txt"));
+    ASSERT_TRUE(fs->writeFile("cold.txt", std::string(1000, 'a')));
+    // Popular files push it out of memory into the compressed tier
+    for (size_t i = 0; i < 200; ++i) {
+        std::string name = "hot_" + std::to_string(i) + ".txt";
+        ASSERT_TRUE(fs->createFile(name));
+        ASSERT_TRUE(fs->writeFile(name, std::string(1000, 'h')));
+    }
+    fs->setCacheAdmissionPolicy(mtfs::cache::AdmissionPolicy::TinyLFU);
+    for (size_t round = 0; round < 5; ++round) {
+        for (size_t i = 0; i < 200; ++i) {
+            fs->readFile("hot_" + std::to_string(i) + ".txt");
+        }
+    }
+
+    ASSERT_TRUE(fs->writeFile("cold.txt", std::string(1000, 'b')));
+    ASSERT_GT(fs->getCacheStatistics().admissionsRejected, 0u);
+    ASSERT_EQ(fs->readFile("cold.txt"), std::string(1000, 'b'));
+    fs->setCacheAdmissionPolicy(mtfs::cache::AdmissionPolicy::None);
+    fs->setCacheCompression(0);
+}
+
+// Hot files are ranked by how often they are read, not by cache order
+TEST_F(FileSystemTest, HotFileRanking) {
+    const int reads[] = {3, 40, 1, 25, 10};
+    for (int i = 0; i < 5; ++i) {
+        std::string name = "ranked_" + std::to_string(i) + ".txt";
+        ASSERT_TRUE(fs->createFile(name));
+        ASSERT_TRUE(fs->writeFile(name, "data " + std::to_string(i)));
+    }
+    for (int i = 0; i < 5; ++i) {
+        for (int r = 0; r < reads[i]; ++r) {
+            fs->readFile("ranked_" + std::to_string(i) + ".txt");
+        }
+    }
+
+    auto hot = fs->getHotFiles(3);
+    ASSERT_EQ(hot, (std::vector<std::string>{"ranked_1.txt", "ranked_3.txt", "ranked_4.txt"}));
+
+    // Deleted files drop out of the ranking
+    ASSERT_TRUE(fs->deleteFile("ranked_1.txt"));
+    hot = fs->getHotFiles(2);
+    ASSERT_EQ(hot, (std::vector<std::string>{"ranked_3.txt", "ranked_4.txt"}));
+}
+
+TEST_F(FileSystemTest, CacheAutoTuning) {
+    const size_t hotFiles = 16;
+    const size_t coldFiles = 200;
+    const std::string body(1024, 'x');
+    fs->setPrefetchEnabled(false);
+    fs->resizeCache(64 * 1024);
+    fs->setCachePolicy(mtfs::cache::CachePolicy::FIFO);
+    fs->setCacheAutoTuning(true);
+    for (size_t i = 0; i < hotFiles; ++i) {
+        ASSERT_TRUE(fs->createFile("hot_" + std::to_string(i) + ".dat"));
+        ASSERT_TRUE(fs->writeFile("hot_" + std::to_string(i) + ".dat", body));
+    }
+    for (size_t i = 0; i < coldFiles; ++i) {
+        ASSERT_TRUE(fs->createFile("cold_" + std::to_string(i) + ".dat"));
+        ASSERT_TRUE(fs->writeFile("cold_" + std::to_string(i) + ".dat", body));
+    }
+
+    // A small hot set read between files that are never reused soon enough:
+    // FIFO evicts the hot files on schedule, recency-aware policies keep them
+    auto readMix = [&](size_t steps) {
+        for (size_t step = 0; step < steps; ++step) {
+            fs->readFile("hot_" + std::to_string(step % hotFiles) + ".dat");
+            fs->readFile("cold_" + std::to_string(step % coldFiles) + ".dat");
+        }
+    };
+    readMix(4000);
+    auto tuning = fs->getCacheTuningStatistics();
+    ASSERT_TRUE(tuning.enabled);
+    ASSERT_NE(fs->getCachePolicy(), mtfs::cache::CachePolicy::FIFO);
+    ASSERT_EQ(tuning.livePolicy, fs->getCachePolicy());
+    ASSERT_EQ(tuning.switches, 1u);
+
+    // The policies left are about as good, so it stays put
+    readMix(8000);
+    tuning = fs->getCacheTuningStatistics();
+    ASSERT_GT(tuning.evaluations, 4u);
+    ASSERT_EQ(tuning.switches, 1u);
+
+    fs->setCacheAutoTuning(false);
+    ASSERT_FALSE(fs->getCacheTuningStatistics().enabled);
+    fs->setCachePolicy(mtfs::cache::CachePolicy::LRU);
+}
+
+// A read that misses while the file is rewritten never leaves the old
+// contents cached after the write
+TEST_F(FileSystemTest, ReadRacingWriteNotCachedStale) {
+    fs->setPrefetchEnabled(false);
+    ASSERT_TRUE(fs->createFile("race.txt"));
+    const std::string large(200000, 'a');
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_TRUE(fs->writeFile("race.txt", large));
+        fs->invalidateCachedFile("race.txt");
+        std::thread reader([this]() { fs->readFile("race.txt"); });
+        std::string latest = "version " + std::to_string(i);
+        bool written = fs->writeFile("race.txt", latest);
+        reader.join();
+        ASSERT_TRUE(written);
+        ASSERT_EQ(fs->readFile("race.txt"), latest);
+    }
+}
+
+// Concurrent misses on one file share a single disk load
+TEST_F(FileSystemTest, ConcurrentMissesCoalesce) {
+    constexpr int READERS = 8;
+    const std::string data(1024 * 1024, 'c');
+    fs->setPrefetchEnabled(false);
+
+    for (int round = 0; round < 20; ++round) {
+        const std::string path = "coalesce_" + std::to_string(round) + ".dat";
+        ASSERT_TRUE(fs->createFile(path));
+        ASSERT_TRUE(fs->writeFile(path, data));
+        fs->clearCache();
+        fs->resetStats();
+
+        std::atomic<bool> go{false};
+        std::atomic<int> wrong{0};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < READERS; ++r) {
+            readers.emplace_back([&] {
+                while (!go) {
+                    std::this_thread::yield();
+                }
+                if (fs->readFile(path) != data) {
+                    wrong++;
+                }
+            });
+        }
+        go = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        ASSERT_EQ(wrong, 0);
+        auto stats = fs->getStats();
+        ASSERT_EQ(stats.diskLoads, 1u);
+        ASSERT_EQ(stats.totalReads, static_cast<size_t>(READERS));
+    }
+}
+
 // Test low-level operations
 TEST_F(FileSystemTest, LowLevelOperations) {
     const std::string testFile = "binary.dat";
@@ -13,7 +13,8 @@ namespace mtfs::threading {
 
 class ThreadPool {
 public:
-    ThreadPool();
+    // threadCount of zero uses one worker per hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
     ~ThreadPool();
 
     // Disable copying
@@ -45,12 +46,13 @@ private:
     mutable std::mutex poolMutex;
     std::condition_variable condition;
     
+    const size_t threadCount;
     bool running{false};
     bool paused{false};
     size_t activeWorkers{0};
 };
 
-// Implementation details will be in a separate .tpp file
-#include "threading/thread_pool.tpp"
+} // namespace mtfs::threading
 
-} // namespace mtfs::threading 
\ No newline at end of file
+// Include implementation files
+#include "threading/thread_pool.tpp" 
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include "threading/thread_pool.hpp"
+#pragma once
 
 namespace mtfs::threading {
 
@@ -1,5 +1,6 @@
 #include "threading/thread_pool.hpp"
 #include <thread>
+#include <algorithm>
 
 namespace mtfs::threading {
 
@@ -8,8 +9,8 @@ void ThreadPool::start() {
     if (running) return;
     running = true;
     paused = false;
-    size_t threadCount = std::thread::hardware_concurrency();
-    for (size_t i = 0; i < threadCount; ++i) {
+    size_t workerCount = threadCount > 0 ? threadCount : std::thread::hardware_concurrency();
+    for (size_t i = 0; i < std::max<size_t>(1, workerCount); ++i) {
         workers.emplace_back([this] { workerFunction(); });
     }
 }
@@ -84,7 +85,7 @@ void ThreadPool::workerFunction() {
     }
 }
 
-ThreadPool::ThreadPool() {}
+ThreadPool::ThreadPool(size_t threadCount) : threadCount(threadCount) {}
 ThreadPool::~ThreadPool() { stop(); }
 
 } // namespace mtfs::threading
\ No newline at end of file